@@ -0,0 +1,118 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "fixed_size.h"
+#include "matrix_vector.h"
+#include "rng.h"
+#include "vector_add.h"
+#include "vector_reduction.h"
+
+/// Number of elements processed by each measure.
+#define ELEMENTS (1L << 27)
+
+/// Sizes measured: the specialized ones and a few falling back to the
+/// generic kernels.
+long sizes[] = {4, 8, 12, 16, 32, 64, 100};
+#define N_SIZES (sizeof(sizes) / sizeof(sizes[0]))
+
+/// @return The current value of the monotonic clock in seconds.
+double now()
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1E9;
+}
+
+/// Print the time per call of a generic and a specialized kernel
+/// called calls times.
+void report(double generic, double fixed, long calls)
+{
+  printf(" %8.2f %8.2f %6.2fx", generic / calls * 1E9, fixed / calls * 1E9,
+         generic / fixed);
+}
+
+/// Call the generic and the front end kernels many times on vectors
+/// of n elements and on a n x n matrix, and check that they agree.
+void bench(long n)
+{
+  int *a = vector_alloc(n), *b = vector_alloc(n);
+  int *c = vector_alloc(n), *d = vector_alloc(n);
+  matrix_t *m = matrix_alloc(n, n, 0);
+  long calls = ELEMENTS / n, matrix_calls = ELEMENTS / (n * n);
+  double t, generic;
+
+  rng_fill(a, n, 5, 1, 0);
+  rng_fill(b, n, 5, 2, 0);
+  matrix_init_rand(m);
+
+  printf("%5ld", n);
+  t = now();
+  for(long k = 0; k < calls; k++)
+    vector_add_simd(c, a, b, n);
+  generic = now() - t;
+  t = now();
+  for(long k = 0; k < calls; k++)
+    fixed_vector_add(d, a, b, n);
+  report(generic, now() - t, calls);
+  if (memcmp(c, d, n * sizeof(int)) != 0)
+  {
+    printf("\nfixed_vector_add: wrong result\n");
+    exit(1);
+  }
+
+  int sum = 0, fixed_sum = 0;
+  t = now();
+  for(long k = 0; k < calls; k++)
+    sum += vector_reduction_sum(a, n);
+  generic = now() - t;
+  t = now();
+  for(long k = 0; k < calls; k++)
+    fixed_sum += fixed_vector_sum(a, n);
+  report(generic, now() - t, calls);
+  if (sum != fixed_sum)
+  {
+    printf("\nfixed_vector_sum: wrong result\n");
+    exit(1);
+  }
+
+  t = now();
+  for(long k = 0; k < matrix_calls; k++)
+    matrix_vector(c, m, a);
+  generic = now() - t;
+  t = now();
+  for(long k = 0; k < matrix_calls; k++)
+    fixed_matrix_vector(d, m, a);
+  report(generic, now() - t, matrix_calls);
+  if (memcmp(c, d, n * sizeof(int)) != 0)
+  {
+    printf("\nfixed_matrix_vector: wrong result\n");
+    exit(1);
+  }
+  printf("\n");
+
+  free(a);
+  free(b);
+  free(c);
+  free(d);
+  matrix_free(m);
+}
+
+/// Compare the kernels specialized for fixed small sizes with the
+/// generic ones, in nanoseconds per call.
+/// @return Always returns 0.
+int main()
+{
+  printf("kernel: %s\n", fixed_size_best()->name);
+  printf("%5s %26s %26s %26s\n", "", "vector_add", "vector_sum",
+         "matrix_vector");
+  printf("%5s", "n");
+  for(int k = 0; k < 3; k++)
+    printf(" %8s %8s %7s", "generic", "fixed", "");
+  printf("  (ns/call)\n");
+  for(int k = 0; k < N_SIZES; k++)
+    bench(sizes[k]);
+  return 0;
+}
@@ -0,0 +1,167 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "gemm.h"
+
+/// Largest size measured with the naive triple loop.
+#define NAIVE_MAX 1024
+
+/// @return The current value of the monotonic clock in seconds.
+double now()
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1E9;
+}
+
+/// @return Whether c and d hold the same values.
+int matrix_equal(matrix_t *c, matrix_t *d)
+{
+  for(long i = 0; i < c->rows; i++)
+    if (memcmp(&MATRIX_AT(c, i, 0), &MATRIX_AT(d, i, 0),
+               c->cols * sizeof(int)) != 0)
+      return 0;
+  return 1;
+}
+
+int fmatrix_equal(fmatrix_t *c, fmatrix_t *d)
+{
+  for(long i = 0; i < c->rows; i++)
+    for(long j = 0; j < c->cols; j++)
+      if (MATRIX_AT(c, i, j) != MATRIX_AT(d, i, j))
+        return 0;
+  return 1;
+}
+
+/// Print the GFLOP/s of a n x n product that took t seconds.
+void print_gflops(long n, double t)
+{
+  printf(" %9.2f", 2.0 * n * n * n / t / 1E9);
+}
+
+/// Multiply n x n matrices with the naive loop (up to NAIVE_MAX), the
+/// tiled kernel on one thread and on every worker of pool, for int
+/// and float elements. Each tiled result is checked against the naive
+/// one (or the single thread one above NAIVE_MAX).
+void bench(worker_pool_t *single, worker_pool_t *pool, long n)
+{
+  matrix_t *a = matrix_alloc(n, n, 0), *b = matrix_alloc(n, n, 0);
+  matrix_t *c = matrix_alloc(n, n, 0), *d = matrix_alloc(n, n, 0);
+  fmatrix_t *fa = fmatrix_alloc(n, n, 0), *fb = fmatrix_alloc(n, n, 0);
+  fmatrix_t *fc = fmatrix_alloc(n, n, 0), *fd = fmatrix_alloc(n, n, 0);
+  double t;
+
+  if (!a || !b || !c || !d || !fa || !fb || !fc || !fd)
+  {
+    printf("cannot allocate %ld x %ld matrices\n", n, n);
+    exit(1);
+  }
+  matrix_fill_rand(pool, a, 1);
+  matrix_fill_rand(pool, b, 2);
+  fmatrix_fill_rand(pool, fa, 1);
+  fmatrix_fill_rand(pool, fb, 2);
+
+  printf("%6ld", n);
+  if (n <= NAIVE_MAX)
+  {
+    t = now();
+    gemm_naive(d, a, b);
+    print_gflops(n, now() - t);
+  }
+  else
+    printf(" %9s", "-");
+  t = now();
+  gemm(single, c, a, b);
+  print_gflops(n, now() - t);
+  if (n <= NAIVE_MAX && !matrix_equal(c, d))
+  {
+    printf("\ngemm: wrong result\n");
+    exit(1);
+  }
+  memcpy(d->data, c->data, c->size);
+  t = now();
+  gemm(pool, c, a, b);
+  print_gflops(n, now() - t);
+  if (!matrix_equal(c, d))
+  {
+    printf("\nparallel gemm: wrong result\n");
+    exit(1);
+  }
+
+  if (n <= NAIVE_MAX)
+  {
+    t = now();
+    fgemm_naive(fd, fa, fb);
+    print_gflops(n, now() - t);
+  }
+  else
+    printf(" %9s", "-");
+  t = now();
+  fgemm(single, fc, fa, fb);
+  print_gflops(n, now() - t);
+  if (n <= NAIVE_MAX && !fmatrix_equal(fc, fd))
+  {
+    printf("\nfgemm: wrong result\n");
+    exit(1);
+  }
+  memcpy(fd->data, fc->data, fc->size);
+  t = now();
+  fgemm(pool, fc, fa, fb);
+  print_gflops(n, now() - t);
+  if (!fmatrix_equal(fc, fd))
+  {
+    printf("\nparallel fgemm: wrong result\n");
+    exit(1);
+  }
+  printf("\n");
+
+  matrix_free(a);
+  matrix_free(b);
+  matrix_free(c);
+  matrix_free(d);
+  fmatrix_free(fa);
+  fmatrix_free(fb);
+  fmatrix_free(fc);
+  fmatrix_free(fd);
+}
+
+/// Report the GFLOP/s of the naive and tiled products of n x n
+/// matrices, for the sizes given on the command line or from 64 to
+/// 2048 by default.
+/// @return Always returns 0.
+int main(int argc, char *argv[])
+{
+  int threads = sysconf(_SC_NPROCESSORS_ONLN);
+  int opt;
+
+  while ((opt = getopt(argc, argv, "t:")) != -1)
+  {
+    if (opt != 't')
+    {
+      printf("Usage : %s [-t threads] [size...]\n", argv[0]);
+      return 1;
+    }
+    threads = atoi(optarg);
+  }
+  worker_pool_t *single = worker_pool_init(1);
+  worker_pool_t *pool = worker_pool_init(threads);
+
+  printf("kernel: %s (%d x %ld tiles), threads: %d\n", gemm_best()->name,
+         GEMM_MR, gemm_best()->nr, pool->n_workers);
+  printf("%6s %9s %9s %9s %9s %9s %9s  (GFLOP/s)\n", "n", "int naive",
+         "tiled", "parallel", "flt naive", "tiled", "parallel");
+  if (optind == argc)
+    for(long n = 64; n <= 2048; n *= 2)
+      bench(single, pool, n);
+  else
+    for(int i = optind; i < argc; i++)
+      bench(single, pool, atol(argv[i]));
+
+  worker_pool_shutdown(single);
+  worker_pool_shutdown(pool);
+  return 0;
+}
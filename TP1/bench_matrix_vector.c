@@ -0,0 +1,200 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "matrix_vector.h"
+#include "rng.h"
+
+/// Number of bytes of matrix read by each measure, so that small
+/// matrices are multiplied many times.
+#define BYTES_PER_MEASURE (1L << 28)
+
+/// Number of measures of each variant. The best one is kept.
+#define MEASURES 3
+
+/// @return The current value of the monotonic clock in seconds.
+double now()
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1E9;
+}
+
+/// The loop of td1.3_matrix_vector_multiply.c: column-order traversal
+/// of a row-major matrix, each element scaled into d.
+void legacy_column_order(matrix_t *d, matrix_t *m, int *v)
+{
+  for(long i = 0; i < m->cols; i++)
+    for(long j = 0; j < m->rows; j++)
+      MATRIX_AT(d, j, i) = MATRIX_AT(m, j, i) * v[i];
+}
+
+/// The loop of td1.3_matrix_vector_multiply_b.c: row-order traversal.
+void legacy_row_order(matrix_t *d, matrix_t *m, int *v)
+{
+  for(long j = 0; j < m->rows; j++)
+    for(long i = 0; i < m->cols; i++)
+      MATRIX_AT(d, j, i) = MATRIX_AT(m, j, i) * v[i];
+}
+
+/// The variants compared by the benchmark.
+enum
+{
+  COLUMN_ORDER,   ///< td1.3 loop
+  ROW_ORDER,      ///< td1.3 _b loop
+  SCALAR_MV,      ///< y = M.v, scalar kernel
+  SIMD_MV,        ///< y = M.v, fastest kernel
+  PARALLEL_MV,    ///< y = M.v, fastest kernel on the worker pool
+  N_VARIANTS
+};
+
+char *variant_names[] = {"column", "row", "scalar", "simd", "parallel"};
+
+worker_pool_t *pool;
+
+/// Flags of the matrices (MATRIX_HUGE_PAGES with -H).
+int matrix_flags = 0;
+
+/// Run a variant once.
+void run(int variant, matrix_t *d, int *y, matrix_t *m, int *v)
+{
+  switch (variant)
+  {
+  case COLUMN_ORDER:
+    legacy_column_order(d, m, v);
+    break;
+  case ROW_ORDER:
+    legacy_row_order(d, m, v);
+    break;
+  case SCALAR_MV:
+    matrix_vector_kernel(matrix_vector_kernels, y, m, v);
+    break;
+  case SIMD_MV:
+    matrix_vector(y, m, v);
+    break;
+  case PARALLEL_MV:
+    parallel_matrix_vector(pool, y, m, v);
+    break;
+  }
+}
+
+/// @return The best time of a run of variant over MEASURES, in seconds.
+double measure(int variant, matrix_t *d, int *y, matrix_t *m, int *v)
+{
+  long repeats = BYTES_PER_MEASURE / (m->rows * m->cols * sizeof(int));
+  double best = 0;
+
+  if (repeats < 1)
+    repeats = 1;
+  for(int r = 0; r < MEASURES; r++)
+  {
+    double t0 = now();
+    for(long k = 0; k < repeats; k++)
+      run(variant, d, y, m, v);
+    double t = (now() - t0) / repeats;
+    if (r == 0 || t < best)
+      best = t;
+  }
+  return best;
+}
+
+/// Multiply a rows x cols matrix by a vector with each variant and
+/// report the time of a product and the bandwidth of the matrix read.
+void bench(long rows, long cols)
+{
+  matrix_t *m = matrix_alloc(rows, cols, matrix_flags);
+  matrix_t *d = matrix_alloc(rows, cols, matrix_flags);
+  int *v = vector_alloc(cols);
+  int *y = vector_alloc(rows);
+  int *expected = vector_alloc(rows);
+
+  if (m == NULL || d == NULL || v == NULL || y == NULL || expected == NULL)
+  {
+    printf("cannot allocate a %ld x %ld matrix\n", rows, cols);
+    exit(1);
+  }
+  matrix_fill_rand(pool, m, MATRIX_SEED);
+  parallel_rng_fill(pool, v, cols, 5, MATRIX_SEED + 1);
+  matrix_vector_kernel(matrix_vector_kernels, expected, m, v);
+
+  printf("%6ld x %-6ld", rows, cols);
+  for(int variant = 0; variant < N_VARIANTS; variant++)
+  {
+    double t = measure(variant, d, y, m, v);
+    printf(" %9.3f %6.2f", t * 1E3, rows * cols * sizeof(int) / t / 1E9);
+    if (variant >= SCALAR_MV && memcmp(y, expected, rows * sizeof(int)) != 0)
+    {
+      printf("\n%s: wrong result\n", variant_names[variant]);
+      exit(1);
+    }
+  }
+  printf("\n");
+
+  matrix_free(m);
+  matrix_free(d);
+  free(v);
+  free(y);
+  free(expected);
+}
+
+/// Print the usage of the benchmark and exit.
+void usage(char *name)
+{
+  printf("Usage : %s [-t threads] [-H] [rows [cols]]\n", name);
+  printf("  -t : number of threads of the parallel variant\n");
+  printf("  -H : back the matrices with huge pages\n");
+  exit(1);
+}
+
+/// Benchmark y = M.v against the loops of td1.3, on the rows x cols
+/// matrix given on the command line (square if cols is omitted) or on
+/// square matrices from 500 to 8000.
+/// @return Always returns 0.
+int main(int argc, char *argv[])
+{
+  int threads = sysconf(_SC_NPROCESSORS_ONLN);
+  int opt;
+
+  while ((opt = getopt(argc, argv, "t:H")) != -1)
+  {
+    switch (opt)
+    {
+    case 't':
+      threads = atoi(optarg);
+      break;
+    case 'H':
+      matrix_flags |= MATRIX_HUGE_PAGES;
+      break;
+    default:
+      usage(argv[0]);
+    }
+  }
+  if (argc - optind > 2)
+    usage(argv[0]);
+  long rows = (optind < argc) ? atol(argv[optind]) : 0;
+  long cols = (optind + 1 < argc) ? atol(argv[optind + 1]) : rows;
+  if ((optind < argc) && ((rows < 1) || (cols < 1)))
+    usage(argv[0]);
+  pool = worker_pool_init(threads);
+
+  printf("kernel: %s, threads: %d%s\n%15s", matrix_vector_best()->name,
+         pool->n_workers, (matrix_flags) ? ", huge pages" : "", "");
+  for(int variant = 0; variant < N_VARIANTS; variant++)
+    printf(" %9s %6s", variant_names[variant], "GB/s");
+  printf("\n%15s", "");
+  for(int variant = 0; variant < N_VARIANTS; variant++)
+    printf(" %9s %6s", "(ms)", "");
+  printf("\n");
+
+  if (rows == 0)
+    for(long size = 500; size <= 8000; size *= 2)
+      bench(size, size);
+  else
+    bench(rows, cols);
+
+  worker_pool_shutdown(pool);
+  return 0;
+}
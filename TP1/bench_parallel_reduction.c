@@ -0,0 +1,122 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "parallel_reduction.h"
+#include "rng.h"
+
+/// Number of measures for each operator and number of threads. The
+/// best one is kept.
+#define MEASURES 5
+
+/// @return The current value of the monotonic clock in seconds.
+double now()
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1E9;
+}
+
+/// Measure the parallel reduction of a with op.
+/// @param seconds Set to the best time over MEASURES runs.
+/// @return The result of the reduction.
+long measure(worker_pool_t *pool, reduction_op_t *op, int *a, long n,
+             double *seconds)
+{
+  long result = 0;
+
+  *seconds = 0;
+  for(int m = 0; m < MEASURES; m++)
+  {
+    double t0 = now();
+    result = parallel_reduction(pool, op, a, n);
+    double t = now() - t0;
+    if (m == 0 || t < *seconds)
+      *seconds = t;
+  }
+  return result;
+}
+
+/// @return The number of threads measured after t: 1, 2, 4, ... up
+/// to max_threads, then max_threads itself.
+int next_threads(int t, int max_threads)
+{
+  if (t < max_threads && 2 * t > max_threads)
+    return max_threads;
+  return 2 * t;
+}
+
+/// Reduce a vector of n elements (256M by default) with each operator
+/// on 1 to max_threads threads (the number of online processors by
+/// default) and report the bandwidth and the speedup over 1 thread.
+/// @return Always returns 0.
+int main(int argc, char *argv[])
+{
+  long n = (argc > 1) ? atol(argv[1]) : 256L << 20;
+  int max_threads = (argc > 2) ? atoi(argv[2]) : sysconf(_SC_NPROCESSORS_ONLN);
+  reduction_op_t **op;
+
+  if ((argc > 3) || (n < 1) || (max_threads < 1))
+  {
+    printf("Usage : %s [n [max_threads]]\n", argv[0]);
+    return 1;
+  }
+
+  int *a = malloc(n * sizeof(int));
+  if (a == NULL)
+  {
+    printf("cannot allocate %ld elements\n", n);
+    return 1;
+  }
+  for(long i = 0; i < n; i++)
+    a[i] = (int) rng_at(1, i) >> 1;
+
+  int n_ops = 0;
+  while (reduction_ops[n_ops])
+    n_ops++;
+  long *expected = malloc(n_ops * sizeof(long));
+  double *base = malloc(n_ops * sizeof(double));
+
+  printf("n=%ld (%ld MB), chunk=%d elements\n", n, n * sizeof(int) >> 20,
+         REDUCTION_CHUNK);
+  printf("%8s", "threads");
+  for(op = reduction_ops; *op; op++)
+    printf(" %8s GB/s speedup", (*op)->name);
+  printf("\n");
+
+  for(int t = 1; t <= max_threads; t = next_threads(t, max_threads))
+  {
+    worker_pool_t *pool = worker_pool_init(t);
+
+    printf("%8d", t);
+    for(op = reduction_ops; *op; op++)
+    {
+      int k = op - reduction_ops;
+      double seconds;
+      long result = measure(pool, *op, a, n, &seconds);
+
+      if (t == 1)
+      {
+        expected[k] = result;
+        base[k] = seconds;
+      }
+      else if (result != expected[k])
+      {
+        printf("\n%s: %ld on %d threads, %ld on 1 thread\n", (*op)->name,
+               result, t, expected[k]);
+        return 1;
+      }
+      printf(" %13.2f %6.2fx", n * sizeof(int) / seconds / 1E9,
+             base[k] / seconds);
+    }
+    printf("\n");
+    worker_pool_shutdown(pool);
+  }
+
+  free(expected);
+  free(base);
+  free(a);
+  return 0;
+}
@@ -0,0 +1,125 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "rng.h"
+#include "vector_reduction.h"
+
+/// Number of bytes read by each measure, so that small vectors are
+/// reduced many times and the timer resolution does not matter.
+#define BYTES_PER_MEASURE (1L << 28)
+
+/// Number of measures for each kernel and size. The best one is kept.
+#define MEASURES 3
+
+/// @return The current value of the monotonic clock in seconds.
+double now()
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1E9;
+}
+
+/// Measure the bandwidth of a kernel.
+/// @param k The kernel to measure.
+/// @param wide Measure the 64-bit accumulation instead of the 32-bit one.
+/// @param a The vector to reduce.
+/// @param n Size of the vector.
+/// @param expected The expected 64-bit sum of a, used to check the kernel.
+/// @return The best bandwidth over MEASURES runs, in GB/s.
+double measure(vector_reduction_kernel_t *k, int wide, int *a, long n,
+               long expected)
+{
+  long repeats = BYTES_PER_MEASURE / (n * sizeof(int));
+  double best = 0;
+  volatile long sink;
+
+  if (repeats < 1)
+    repeats = 1;
+  for(int m = 0; m < MEASURES; m++)
+  {
+    double t0 = now();
+    for(long r = 0; r < repeats; r++)
+      sink = (wide) ? k->sum64(a, n) : k->sum(a, n);
+    double t1 = now();
+
+    if ((wide && sink != expected) || (!wide && (int) sink != (int) expected))
+    {
+      printf("%s: wrong sum for n=%ld\n", k->name, n);
+      exit(1);
+    }
+    double gbs = repeats * n * sizeof(int) / (t1 - t0) / 1E9;
+    if (best < gbs)
+      best = gbs;
+  }
+  return best;
+}
+
+/// Print the bandwidth of each supported kernel for sizes from min_n
+/// to max_n, and the speedup of the fastest one over the scalar one.
+void sweep(int wide, int *a, long min_n, long max_n)
+{
+  vector_reduction_kernel_t *k;
+
+  printf("\n%s-bit accumulation (GB/s)\n%12s %10s", (wide) ? "64" : "32",
+         "n", "bytes");
+  for(k = vector_reduction_kernels; k->name; k++)
+    if (vector_reduction_supported(k))
+      printf(" %8s", k->name);
+  printf(" %8s\n", "speedup");
+
+  for(long n = min_n; n <= max_n; n *= 4)
+  {
+    long expected = 0;
+    double scalar = 0, fastest = 0;
+
+    for(long i = 0; i < n; i++)
+      expected += a[i];
+    printf("%12ld %10ld", n, n * (long) sizeof(int));
+    for(k = vector_reduction_kernels; k->name; k++)
+    {
+      if (!vector_reduction_supported(k))
+        continue;
+      double gbs = measure(k, wide, a, n, expected);
+      if (k == vector_reduction_kernels)
+        scalar = gbs;
+      if (fastest < gbs)
+        fastest = gbs;
+      printf(" %8.2f", gbs);
+    }
+    printf(" %7.2fx\n", fastest / scalar);
+  }
+}
+
+/// Sweep the vector size from L1-resident (1K elements) to
+/// DRAM-sized (max_n elements, 64M by default) and report the
+/// bandwidth of each reduction kernel.
+/// @return Always returns 0.
+int main(int argc, char *argv[])
+{
+  long max_n = (argc > 1) ? atol(argv[1]) : 64L << 20;
+
+  if ((argc > 2) || (max_n < 1024))
+  {
+    printf("Usage : %s [max_n >= 1024]\n", argv[0]);
+    return 1;
+  }
+
+  int *a = malloc(max_n * sizeof(int));
+  if (a == NULL)
+  {
+    printf("cannot allocate %ld elements\n", max_n);
+    return 1;
+  }
+  rng_fill(a, max_n, 5, 1, 0);
+  for(long i = 0; i < max_n; i++)
+    a[i] -= 2;
+
+  printf("selected kernel: %s\n", vector_reduction_best()->name);
+  sweep(0, a, 1024, max_n);
+  sweep(1, a, 1024, max_n);
+
+  free(a);
+  return 0;
+}
@@ -0,0 +1,99 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "rng.h"
+
+/// Seed of the measured fills.
+#define SEED 1
+
+/// @return The current value of the monotonic clock in seconds.
+double now()
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1E9;
+}
+
+/// Print the time of a fill of n elements and its speedup over the
+/// rand() loop, which took base seconds.
+void report(char *name, long n, double t, double base)
+{
+  printf("%-16s %9.2f ms %7.2f GB/s %8.1fx\n", name, t * 1E3,
+         n * sizeof(int) / t / 1E9, base / t);
+}
+
+/// @return The number of threads measured after t: 1, 2, 4, ... up
+/// to max_threads, then max_threads itself.
+int next_threads(int t, int max_threads)
+{
+  if (t < max_threads && 2 * t > max_threads)
+    return max_threads;
+  return 2 * t;
+}
+
+/// Fill n integers modulo 5 with the rand() loop the inputs used to
+/// be initialized with, with rng_fill on one thread, and with
+/// parallel_rng_fill on 1, 2, 4, ... max_threads threads. Each
+/// parallel fill must give exactly the serial one.
+/// @return 0 on success, 1 on error.
+int main(int argc, char *argv[])
+{
+  long n = (argc > 1) ? atol(argv[1]) : 64L << 20;
+  int max_threads = (argc > 2) ? atoi(argv[2]) : sysconf(_SC_NPROCESSORS_ONLN);
+  char name[32];
+  double t, base;
+
+  if ((argc > 3) || (n < 1) || (max_threads < 1))
+  {
+    printf("Usage : %s [n [max_threads]]\n", argv[0]);
+    return 1;
+  }
+
+  int *a = malloc(n * sizeof(int));
+  int *b = malloc(n * sizeof(int));
+  if (a == NULL || b == NULL)
+  {
+    printf("cannot allocate %ld elements\n", n);
+    return 1;
+  }
+  // Touch the pages before measuring
+  memset(a, 0, n * sizeof(int));
+  memset(b, 0, n * sizeof(int));
+
+  printf("n=%ld (%ld MB)\n", n, n * sizeof(int) >> 20);
+  t = now();
+  for(long i = 0; i < n; i++)
+    a[i] = rand() % 5;
+  base = now() - t;
+  report("rand() % 5", n, base, base);
+
+  t = now();
+  rng_fill(a, n, 5, SEED, 0);
+  report("rng_fill", n, now() - t, base);
+
+  for(int threads = 1; threads <= max_threads;
+      threads = next_threads(threads, max_threads))
+  {
+    worker_pool_t *pool = worker_pool_init(threads);
+
+    memset(b, 0xff, n * sizeof(int));
+    t = now();
+    parallel_rng_fill(pool, b, n, 5, SEED);
+    snprintf(name, sizeof(name), "parallel (%d)", threads);
+    report(name, n, now() - t, base);
+    worker_pool_shutdown(pool);
+    if (memcmp(a, b, n * sizeof(int)) != 0)
+    {
+      printf("%s: differs from rng_fill\n", name);
+      return 1;
+    }
+  }
+
+  free(a);
+  free(b);
+  return 0;
+}
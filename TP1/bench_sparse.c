@@ -0,0 +1,255 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "matrix_vector.h"
+#include "rng.h"
+#include "sparse.h"
+
+/// Number of bytes of dense matrix read by each measure, so that small
+/// matrices are multiplied many times.
+#define BYTES_PER_MEASURE (1L << 28)
+
+/// Most products per measure, for tiny matrices.
+#define MAX_REPEATS 10000
+
+/// Number of measures of each variant. The best one is kept.
+#define MEASURES 3
+
+/// Densities measured, in percent.
+double densities[] = {0.1, 0.5, 1, 2, 5, 10, 15, 20, 30, 40, 50, 75, 100};
+#define N_DENSITIES (sizeof(densities) / sizeof(densities[0]))
+
+/// @return The current value of the monotonic clock in seconds.
+double now()
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1E9;
+}
+
+/// The variants compared by the benchmark.
+enum
+{
+  DENSE,              ///< matrix_vector, fastest kernel
+  PARALLEL_DENSE,     ///< parallel_matrix_vector
+  CSR,                ///< csr_matrix_vector
+  PARALLEL_CSR_ROWS,  ///< CSR, the same number of rows per worker
+  PARALLEL_CSR,       ///< parallel_csr_matrix_vector (balanced nnz)
+  N_VARIANTS
+};
+
+char *variant_names[] = {"dense", "par", "csr", "par rows", "par nnz"};
+
+worker_pool_t *pool;
+
+/// Whether the nonzero elements are concentrated in the first rows
+/// (-s).
+int skewed = 0;
+
+/// A CSR product split by rows, shared by the workers.
+typedef struct
+{
+  int *y;
+  csr_t *a;
+  int *v;
+} rows_product_t;
+
+/// Multiply the rows of worker id, without looking at their nonzero
+/// elements.
+void rows_worker(void *arg, int id)
+{
+  rows_product_t *p = arg;
+  long first, last;
+
+  worker_pool_range(pool, id, p->a->rows, &first, &last);
+  csr_matrix_vector_rows(p->y, p->a, p->v, first, last);
+}
+
+/// Run a variant once.
+void run(int variant, int *y, matrix_t *m, csr_t *a, int *v)
+{
+  rows_product_t p = {y, a, v};
+
+  switch (variant)
+  {
+  case DENSE:
+    matrix_vector(y, m, v);
+    break;
+  case PARALLEL_DENSE:
+    parallel_matrix_vector(pool, y, m, v);
+    break;
+  case CSR:
+    csr_matrix_vector(y, a, v);
+    break;
+  case PARALLEL_CSR_ROWS:
+    worker_pool_run(pool, rows_worker, &p);
+    break;
+  case PARALLEL_CSR:
+    parallel_csr_matrix_vector(pool, y, a, v);
+    break;
+  }
+}
+
+/// @return The best time of a run of variant over MEASURES, in seconds.
+double measure(int variant, int *y, matrix_t *m, csr_t *a, int *v)
+{
+  long repeats = BYTES_PER_MEASURE / (m->rows * m->cols * sizeof(int));
+  double best = 0;
+
+  if (repeats < 1)
+    repeats = 1;
+  if (repeats > MAX_REPEATS)
+    repeats = MAX_REPEATS;
+  for(int r = 0; r < MEASURES; r++)
+  {
+    double t0 = now();
+    for(long k = 0; k < repeats; k++)
+      run(variant, y, m, a, v);
+    double t = (now() - t0) / repeats;
+    if (r == 0 || t < best)
+      best = t;
+  }
+  return best;
+}
+
+/// Fill m with nonzero values (1 to 4) at the given density (percent).
+/// Every row has this density, unless skewed is set: the density then
+/// decreases linearly from twice the given one on the first row to 0.
+void matrix_init_sparse(matrix_t *m, double density)
+{
+  for(long i = 0; i < m->rows; i++)
+  {
+    double d = (skewed) ? 2 * density * (m->rows - i) / m->rows : density;
+    long threshold = (d >= 100) ? RNG_RANGE_MAX : d / 100 * RNG_RANGE_MAX;
+    int *row = matrix_row(m, i);
+
+    rng_fill(row, m->cols, RNG_RANGE_MAX, MATRIX_SEED, i * m->cols);
+    for(long j = 0; j < m->cols; j++)
+      row[j] = (row[j] < threshold) ? 1 + row[j] % 4 : 0;
+  }
+}
+
+/// Multiply a rows x cols matrix of each density by a vector with
+/// every variant, report the time of a product, and the densities
+/// from which the dense products beat the sparse ones.
+void bench(long rows, long cols)
+{
+  matrix_t *m = matrix_alloc(rows, cols, 0);
+  int *v = vector_alloc(cols);
+  int *y = vector_alloc(rows);
+  int *expected = vector_alloc(rows);
+  double crossover = -1, parallel_crossover = -1;
+
+  if (m == NULL || v == NULL || y == NULL || expected == NULL)
+  {
+    printf("cannot allocate a %ld x %ld matrix\n", rows, cols);
+    exit(1);
+  }
+  rng_fill(v, cols, 5, MATRIX_SEED + 1, 0);
+
+  printf("%ld x %ld%s\n%8s %10s", rows, cols, (skewed) ? ", skewed" : "",
+         "density", "nnz");
+  for(int variant = 0; variant < N_VARIANTS; variant++)
+    printf(" %9s", variant_names[variant]);
+  printf("  (ms)\n");
+
+  for(int k = 0; k < N_DENSITIES; k++)
+  {
+    double t[N_VARIANTS];
+
+    matrix_init_sparse(m, densities[k]);
+    csr_t *a = csr_from_matrix(m);
+    if (a == NULL)
+    {
+      printf("cannot allocate a sparse matrix\n");
+      exit(1);
+    }
+    matrix_vector(expected, m, v);
+
+    printf("%7.1f%% %10ld", densities[k], a->nnz);
+    for(int variant = 0; variant < N_VARIANTS; variant++)
+    {
+      memset(y, 0, rows * sizeof(int));
+      t[variant] = measure(variant, y, m, a, v);
+      printf(" %9.3f", t[variant] * 1E3);
+      if (memcmp(y, expected, rows * sizeof(int)) != 0)
+      {
+        printf("\n%s: wrong result\n", variant_names[variant]);
+        exit(1);
+      }
+    }
+    printf("\n");
+    if (crossover < 0 && t[DENSE] <= t[CSR])
+      crossover = densities[k];
+    if (parallel_crossover < 0 && t[PARALLEL_DENSE] <= t[PARALLEL_CSR])
+      parallel_crossover = densities[k];
+    csr_free(a);
+  }
+
+  if (crossover >= 0)
+    printf("dense beats csr from density %.1f%%\n", crossover);
+  else
+    printf("csr beats dense at every density\n");
+  if (parallel_crossover >= 0)
+    printf("parallel: dense beats csr from density %.1f%%\n",
+           parallel_crossover);
+  else
+    printf("parallel: csr beats dense at every density\n");
+
+  matrix_free(m);
+  free(v);
+  free(y);
+  free(expected);
+}
+
+/// Print the usage of the benchmark and exit.
+void usage(char *name)
+{
+  printf("Usage : %s [-t threads] [-s] [rows [cols]]\n", name);
+  printf("  -t : number of threads of the parallel variants\n");
+  printf("  -s : concentrate the nonzero elements in the first rows\n");
+  exit(1);
+}
+
+/// Benchmark sparse (CSR) against dense matrix vector products, on the
+/// rows x cols matrix given on the command line (square if cols is
+/// omitted, 4096 x 4096 by default) at densities from 0.1 to 100%.
+/// @return Always returns 0.
+int main(int argc, char *argv[])
+{
+  int threads = sysconf(_SC_NPROCESSORS_ONLN);
+  int opt;
+
+  while ((opt = getopt(argc, argv, "t:s")) != -1)
+  {
+    switch (opt)
+    {
+    case 't':
+      threads = atoi(optarg);
+      break;
+    case 's':
+      skewed = 1;
+      break;
+    default:
+      usage(argv[0]);
+    }
+  }
+  if (argc - optind > 2)
+    usage(argv[0]);
+  long rows = (optind < argc) ? atol(argv[optind]) : 4096;
+  long cols = (optind + 1 < argc) ? atol(argv[optind + 1]) : rows;
+  if ((rows < 1) || (cols < 1))
+    usage(argv[0]);
+  pool = worker_pool_init(threads);
+
+  printf("kernel: %s, threads: %d\n", matrix_vector_best()->name,
+         pool->n_workers);
+  bench(rows, cols);
+
+  worker_pool_shutdown(pool);
+  return 0;
+}
@@ -0,0 +1,160 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "rng.h"
+#include "vector_add.h"
+
+/// Number of bytes written by each measure, so that small vectors are
+/// added many times and the timer resolution does not matter.
+#define BYTES_PER_MEASURE (1L << 28)
+
+/// Number of measures of each variant. The best one is kept.
+#define MEASURES 3
+
+/// @return The current value of the monotonic clock in seconds.
+double now()
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1E9;
+}
+
+/// The variants compared by the benchmark.
+enum
+{
+  SCALAR_ADD,   ///< Original scalar loop
+  SIMD_STORE,   ///< Fastest kernel, regular stores
+  SIMD_STREAM,  ///< Fastest kernel, non-temporal stores
+  PARALLEL,     ///< parallel_vector_add (stores chosen by size)
+  TWO_PASSES,   ///< c = a + b + d as c = a + b, then c = c + d
+  FUSED,        ///< c = a + b + d with vector_add3_simd
+  N_VARIANTS
+};
+
+char *variant_names[] =
+  {"scalar", "store", "stream", "parallel", "2-passes", "fused"};
+
+worker_pool_t *pool;
+
+/// Run a variant once.
+void run(int variant, int *c, int *a, int *b, int *d, long n)
+{
+  vector_add_kernel_t *k = vector_add_best();
+
+  switch (variant)
+  {
+  case SCALAR_ADD:
+    vector_add_kernels[0].add(c, a, b, n, 0);
+    break;
+  case SIMD_STORE:
+    k->add(c, a, b, n, 0);
+    break;
+  case SIMD_STREAM:
+    k->add(c, a, b, n, 1);
+    break;
+  case PARALLEL:
+    parallel_vector_add(pool, c, a, b, n);
+    break;
+  case TWO_PASSES:
+    vector_add_simd(c, a, b, n);
+    vector_add_simd(c, c, d, n);
+    break;
+  case FUSED:
+    vector_add3_simd(c, a, b, d, n);
+    break;
+  }
+}
+
+/// Measure a variant and check its result.
+/// @return The best time of an addition over MEASURES runs, in seconds.
+double measure(int variant, int *c, int *a, int *b, int *d, long n)
+{
+  long repeats = BYTES_PER_MEASURE / (n * sizeof(int));
+  double best = 0;
+
+  if (repeats < 1)
+    repeats = 1;
+  for(int m = 0; m < MEASURES; m++)
+  {
+    double t0 = now();
+    for(long r = 0; r < repeats; r++)
+      run(variant, c, a, b, d, n);
+    double t = (now() - t0) / repeats;
+    if (m == 0 || t < best)
+      best = t;
+  }
+
+  for(long i = 0; i < n; i++)
+    if (c[i] != a[i] + b[i] + ((variant >= TWO_PASSES) ? d[i] : 0))
+    {
+      printf("%s: wrong result at %ld for n=%ld\n", variant_names[variant],
+             i, n);
+      exit(1);
+    }
+  return best;
+}
+
+/// Sweep the vector size from L1-resident (1K elements) to
+/// DRAM-sized (max_n elements, 64M by default) and report the
+/// bandwidth (bytes read and written per second) of each variant.
+/// Vectors start one element past an aligned address so that the
+/// kernels go through their unaligned head.
+/// @return Always returns 0.
+int main(int argc, char *argv[])
+{
+  long max_n = (argc > 1) ? atol(argv[1]) : 64L << 20;
+  int threads = (argc > 2) ? atoi(argv[2]) : sysconf(_SC_NPROCESSORS_ONLN);
+
+  if ((argc > 3) || (max_n < 1024) || (threads < 1))
+  {
+    printf("Usage : %s [max_n >= 1024 [threads]]\n", argv[0]);
+    return 1;
+  }
+
+  int *a = malloc((max_n + 1) * sizeof(int));
+  int *b = malloc((max_n + 1) * sizeof(int));
+  int *c = malloc((max_n + 1) * sizeof(int));
+  int *d = malloc((max_n + 1) * sizeof(int));
+  if (a == NULL || b == NULL || c == NULL || d == NULL)
+  {
+    printf("cannot allocate %ld elements\n", max_n);
+    return 1;
+  }
+  pool = worker_pool_init(threads);
+  parallel_rng_fill(pool, a, max_n + 1, 5, 1);
+  parallel_rng_fill(pool, b, max_n + 1, 5, 2);
+  parallel_rng_fill(pool, d, max_n + 1, 5, 3);
+  memset(c, 0, (max_n + 1) * sizeof(int));
+
+  printf("kernel: %s, stream threshold: %ld bytes, threads: %d\n",
+         vector_add_best()->name, vector_add_stream_threshold(), threads);
+  printf("%12s %10s", "n", "bytes");
+  for(int v = 0; v < N_VARIANTS; v++)
+    printf(" %9s", variant_names[v]);
+  printf("  (GB/s)\n");
+
+  for(long n = 1024; n <= max_n; n *= 4)
+  {
+    printf("%12ld %10ld", n, n * (long) sizeof(int));
+    for(int v = 0; v < N_VARIANTS; v++)
+    {
+      double t = measure(v, c + 1, a + 1, b + 1, d + 1, n);
+      // c = a + b moves 3 vectors, c = a + b + d moves 4 whatever the
+      // number of passes
+      long bytes = ((v >= TWO_PASSES) ? 4 : 3) * n * sizeof(int);
+      printf(" %9.2f", bytes / t / 1E9);
+    }
+    printf("\n");
+  }
+
+  worker_pool_shutdown(pool);
+  free(a);
+  free(b);
+  free(c);
+  free(d);
+  return 0;
+}
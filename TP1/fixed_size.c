@@ -0,0 +1,248 @@
+#include <string.h>
+
+#include "fixed_size.h"
+#include "isa.h"
+#include "matrix_vector.h"
+#include "vector_add.h"
+#include "vector_reduction.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define X86 1
+#endif
+
+/// Elements of the vectors used for size N: at most a register of
+/// WIDTH bytes.
+#define CHUNK(N, WIDTH) (((N) * 4 < (WIDTH)) ? (N) : (WIDTH) / 4)
+
+/// Define the horizontal sum of an instruction set.
+/// @param ISA Name of the instruction set.
+/// @param TARGET Attribute enabling the instruction set.
+#define DEFINE_HSUM(ISA, TARGET)                                            \
+  /* @return The sum of the size / 4 elements of vector v (size being */   \
+  /* 16, 32 or 64 bytes), folded to 4 lanes by vector additions. */         \
+  TARGET static inline int hsum_##ISA(void *v, long size)                   \
+  {                                                                         \
+    typedef int vec4 __attribute__((vector_size(16)));                      \
+    vec4 s, x;                                                              \
+                                                                            \
+    memcpy(&s, v, sizeof(vec4));                                            \
+    for(long k = sizeof(vec4); k < size; k += sizeof(vec4))                 \
+    {                                                                       \
+      memcpy(&x, (char *) v + k, sizeof(vec4));                             \
+      s += x;                                                               \
+    }                                                                       \
+    return s[0] + s[1] + s[2] + s[3];                                       \
+  }
+
+/// Define the kernels of size N of an instruction set. They are
+/// written with the vector extensions of the compiler on vectors of
+/// CHUNK(N, WIDTH) elements, and their loops, of constant trip count,
+/// are fully unrolled.
+/// @param N Size of the vectors (columns of the matrix).
+/// @param ISA Name of the instruction set.
+/// @param TARGET Attribute enabling the instruction set.
+/// @param WIDTH Width of the vector registers in bytes.
+#define DEFINE_SIZE_KERNELS(N, ISA, TARGET, WIDTH)                          \
+  TARGET static inline void add_##N##_##ISA(int *c, int *a, int *b)        \
+  {                                                                         \
+    typedef int vec __attribute__((vector_size(CHUNK(N, WIDTH) * 4)));      \
+    const long w = CHUNK(N, WIDTH);                                         \
+                                                                            \
+    _Pragma("GCC unroll 16")                                                \
+    for(long i = 0; i < N; i += w)                                          \
+    {                                                                       \
+      vec x, y;                                                             \
+      memcpy(&x, a + i, sizeof(vec));                                       \
+      memcpy(&y, b + i, sizeof(vec));                                       \
+      x += y;                                                               \
+      memcpy(c + i, &x, sizeof(vec));                                       \
+    }                                                                       \
+  }                                                                         \
+                                                                            \
+  TARGET static inline int sum_##N##_##ISA(int *a)                          \
+  {                                                                         \
+    typedef int vec __attribute__((vector_size(CHUNK(N, WIDTH) * 4)));      \
+    const long w = CHUNK(N, WIDTH);                                         \
+    vec acc = {0};                                                          \
+                                                                            \
+    _Pragma("GCC unroll 16")                                                \
+    for(long i = 0; i < N; i += w)                                          \
+    {                                                                       \
+      vec x;                                                                \
+      memcpy(&x, a + i, sizeof(vec));                                       \
+      acc += x;                                                             \
+    }                                                                       \
+    return hsum_##ISA(&acc, sizeof(vec));                                   \
+  }                                                                         \
+                                                                            \
+  /* y = m.v for a matrix of rows x N elements: v stays in registers. */   \
+  TARGET static inline void matrix_vector_##N##_##ISA(int *y, int *m,      \
+                                                      long rows,            \
+                                                      long stride, int *v)  \
+  {                                                                         \
+    typedef int vec __attribute__((vector_size(CHUNK(N, WIDTH) * 4)));      \
+    const long w = CHUNK(N, WIDTH);                                         \
+    vec vv[N / CHUNK(N, WIDTH)];                                            \
+                                                                            \
+    memcpy(vv, v, sizeof(vv));                                              \
+    for(long i = 0; i < rows; i++, m += stride)                             \
+    {                                                                       \
+      vec acc = {0};                                                        \
+      _Pragma("GCC unroll 16")                                              \
+      for(long j = 0; j < N; j += w)                                        \
+      {                                                                     \
+        vec x;                                                              \
+        memcpy(&x, m + j, sizeof(vec));                                     \
+        acc += x * vv[j / w];                                               \
+      }                                                                     \
+      y[i] = hsum_##ISA(&acc, sizeof(vec));                                 \
+    }                                                                       \
+  }
+
+/// Whether n is one of FIXED_SIZES, tested before any dispatch.
+#define IS_FIXED_SIZE(N, n) || (n) == N
+#define FIXED_SIZE(n) (0 FIXED_SIZES(IS_FIXED_SIZE, n))
+
+#define ADD_CASE(N, ISA)                                                    \
+  case N:                                                                   \
+    add_##N##_##ISA(c, a, b);                                               \
+    return;
+
+#define SUM_CASE(N, ISA)                                                    \
+  case N:                                                                   \
+    return sum_##N##_##ISA(a);
+
+#define MATRIX_VECTOR_CASE(N, ISA)                                          \
+  case N:                                                                   \
+    matrix_vector_##N##_##ISA(y, m->data, m->rows, m->stride, v);           \
+    return;
+
+/// Generic kernels of an instruction set, called by its front ends for
+/// the sizes without a specialized kernel.
+typedef struct
+{
+  vector_add_kernel_t *add;
+  vector_reduction_kernel_t *sum;
+  matrix_vector_kernel_t *matrix_vector;
+} generic_kernels_t;
+
+/// Set K to the entry of the kernel table TABLE for instruction set
+/// ISA, or to its first (scalar) entry if it has none.
+#define FIND_KERNEL(K, TABLE, ISA)                                          \
+  for(K = TABLE; K->name && strcmp(K->name, ISA); K++)                      \
+    ;                                                                       \
+  if (!K->name)                                                             \
+    K = TABLE;
+
+/// Define the front ends of an instruction set: a switch on the size
+/// to its specialized kernel, the generic kernel of the same
+/// instruction set otherwise. The generic kernel is called directly,
+/// not through vector_add_simd and the like, which would dispatch a
+/// second time.
+#define DEFINE_FIXED_KERNELS(ISA, TARGET, WIDTH)                            \
+  DEFINE_HSUM(ISA, TARGET)                                                  \
+  FIXED_SIZES(DEFINE_SIZE_KERNELS, ISA, TARGET, WIDTH)                      \
+                                                                            \
+  static generic_kernels_t generic_##ISA;                                   \
+                                                                            \
+  /* The tables are static data: no need to wait for their constructor. */ \
+  __attribute__((constructor))                                              \
+  static void generic_init_##ISA()                                          \
+  {                                                                         \
+    FIND_KERNEL(generic_##ISA.add, vector_add_kernels, #ISA)                \
+    FIND_KERNEL(generic_##ISA.sum, vector_reduction_kernels, #ISA)          \
+    FIND_KERNEL(generic_##ISA.matrix_vector, matrix_vector_kernels, #ISA)   \
+  }                                                                         \
+                                                                            \
+  TARGET static void add_##ISA(int *c, int *a, int *b, long n)              \
+  {                                                                         \
+    switch (n)                                                              \
+    {                                                                       \
+      FIXED_SIZES(ADD_CASE, ISA)                                            \
+    }                                                                       \
+    generic_##ISA.add->add(c, a, b, n, n * (long) sizeof(int)               \
+                           > vector_add_stream_threshold());                \
+  }                                                                         \
+                                                                            \
+  TARGET static int sum_##ISA(int *a, long n)                               \
+  {                                                                         \
+    switch (n)                                                              \
+    {                                                                       \
+      FIXED_SIZES(SUM_CASE, ISA)                                            \
+    }                                                                       \
+    return generic_##ISA.sum->sum(a, n);                                    \
+  }                                                                         \
+                                                                            \
+  TARGET static void matrix_vector_##ISA(int *y, matrix_t *m, int *v)       \
+  {                                                                         \
+    switch (m->cols)                                                        \
+    {                                                                       \
+      FIXED_SIZES(MATRIX_VECTOR_CASE, ISA)                                  \
+    }                                                                       \
+    matrix_vector_kernel(generic_##ISA.matrix_vector, y, m, v);             \
+  }
+
+#ifdef X86
+#define SSE2 __attribute__((target("sse2")))
+#define AVX2 __attribute__((target("avx2")))
+#define AVX512 __attribute__((target("avx512f")))
+DEFINE_FIXED_KERNELS(sse2, SSE2, 16)
+DEFINE_FIXED_KERNELS(avx2, AVX2, 32)
+DEFINE_FIXED_KERNELS(avx512, AVX512, 64)
+#else
+DEFINE_FIXED_KERNELS(scalar, , 16)
+#endif
+
+fixed_size_kernel_t fixed_size_kernels[] =
+{
+#ifdef X86
+  {"sse2",   add_sse2,   sum_sse2,   matrix_vector_sse2},
+  {"avx2",   add_avx2,   sum_avx2,   matrix_vector_avx2},
+  {"avx512", add_avx512, sum_avx512, matrix_vector_avx512},
+#else
+  {"scalar", add_scalar, sum_scalar, matrix_vector_scalar},
+#endif
+  {NULL}
+};
+
+/// The kernel selected at startup.
+static fixed_size_kernel_t *best = fixed_size_kernels;
+
+/// Select the fastest supported kernel before main starts.
+__attribute__((constructor))
+static void fixed_size_init()
+{
+  for(fixed_size_kernel_t *k = fixed_size_kernels; k->name; k++)
+    if (isa_supported(k->name))
+      best = k;
+}
+
+fixed_size_kernel_t *fixed_size_best()
+{
+  return best;
+}
+
+/// The other sizes go straight to the generic kernels: they cost a
+/// comparison more, not a second dispatch.
+void fixed_vector_add(int *c, int *a, int *b, long n)
+{
+  if (FIXED_SIZE(n))
+    best->add(c, a, b, n);
+  else
+    vector_add_simd(c, a, b, n);
+}
+
+int fixed_vector_sum(int *a, long n)
+{
+  if (FIXED_SIZE(n))
+    return best->sum(a, n);
+  return vector_reduction_sum(a, n);
+}
+
+void fixed_matrix_vector(int *y, matrix_t *m, int *v)
+{
+  if (FIXED_SIZE(m->cols))
+    best->matrix_vector(y, m, v);
+  else
+    matrix_vector(y, m, v);
+}
@@ -0,0 +1,42 @@
+#ifndef FIXED_SIZE_H
+#define FIXED_SIZE_H
+
+#include "matrix.h"
+
+/// Sizes with a specialized kernel. X(N, ...) is applied to each of
+/// them, to generate code for every size.
+#define FIXED_SIZES(X, ...)                                                 \
+  X(4, __VA_ARGS__) X(8, __VA_ARGS__) X(16, __VA_ARGS__)                    \
+  X(32, __VA_ARGS__) X(64, __VA_ARGS__)
+
+/// Kernels for tiny vectors, called in inner loops where the loop
+/// overhead of the generic kernels dominates. For each of FIXED_SIZES,
+/// the size is a compile-time constant and the loops are fully
+/// unrolled. The other sizes fall back to the generic kernels.
+typedef struct
+{
+  /// Name of the instruction set ("scalar", "sse2", "avx2", "avx512").
+  char *name;
+  void (*add)(int *c, int *a, int *b, long n);
+  int (*sum)(int *a, long n);
+  void (*matrix_vector)(int *y, matrix_t *m, int *v);
+} fixed_size_kernel_t;
+
+/// The kernels compiled in, from the most portable to the fastest.
+/// The table is terminated by an entry with a NULL name.
+extern fixed_size_kernel_t fixed_size_kernels[];
+
+/// @return The fastest kernel supported by the processor.
+fixed_size_kernel_t *fixed_size_best();
+
+/// Store a + b in c.
+/// @param n Size of the vectors.
+void fixed_vector_add(int *c, int *a, int *b, long n);
+
+/// @return The sum of the n elements of a.
+int fixed_vector_sum(int *a, long n);
+
+/// Multiply matrix m with vector v and store the result in y. The
+/// kernel is specialized on the number of columns of m.
+void fixed_matrix_vector(int *y, matrix_t *m, int *v);
+#endif
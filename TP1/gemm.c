@@ -0,0 +1,222 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "gemm.h"
+#include "isa.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define X86 1
+#endif
+
+/// Widest tile of C among the kernels (2 AVX-512 vectors of 32-bit
+/// elements).
+#define GEMM_NR_MAX 32
+
+/// Define the micro-kernel of an instruction set for elements of type
+/// T. It is written with the vector extensions of the compiler, which
+/// lower each vector operation to the instructions enabled by TARGET.
+/// The GEMM_MR x 2 accumulators stay in registers during the whole
+/// kc loop and are added to C once. The tile of C must be aligned on
+/// WIDTH bytes, which the padded stride of the matrices guarantees.
+/// @param T Element type.
+/// @param NAME Prefix of the kernel.
+/// @param ISA Name of the instruction set.
+/// @param TARGET Attribute enabling the instruction set.
+/// @param WIDTH Width of the vectors in bytes.
+#define DEFINE_MICRO_KERNEL(T, NAME, ISA, TARGET, WIDTH)                   \
+  TARGET static void NAME##_kernel_##ISA(long kc, T *a, T *b, T *c,        \
+                                         long ldc)                          \
+  {                                                                         \
+    typedef T vec __attribute__((vector_size(WIDTH)));                      \
+    const long h = WIDTH / sizeof(T);                                       \
+    vec c0a = {0}, c0b = {0}, c1a = {0}, c1b = {0}, c2a = {0}, c2b = {0};   \
+    vec c3a = {0}, c3b = {0}, c4a = {0}, c4b = {0}, c5a = {0}, c5b = {0};   \
+                                                                            \
+    for(long p = 0; p < kc; p++, a += GEMM_MR, b += 2 * h)                  \
+    {                                                                       \
+      vec b0 = *(vec *) b, b1 = *(vec *) (b + h);                           \
+      c0a += a[0] * b0; c0b += a[0] * b1;                                   \
+      c1a += a[1] * b0; c1b += a[1] * b1;                                   \
+      c2a += a[2] * b0; c2b += a[2] * b1;                                   \
+      c3a += a[3] * b0; c3b += a[3] * b1;                                   \
+      c4a += a[4] * b0; c4b += a[4] * b1;                                   \
+      c5a += a[5] * b0; c5b += a[5] * b1;                                   \
+    }                                                                       \
+    *(vec *) (c + 0 * ldc) += c0a; *(vec *) (c + 0 * ldc + h) += c0b;       \
+    *(vec *) (c + 1 * ldc) += c1a; *(vec *) (c + 1 * ldc + h) += c1b;       \
+    *(vec *) (c + 2 * ldc) += c2a; *(vec *) (c + 2 * ldc + h) += c2b;       \
+    *(vec *) (c + 3 * ldc) += c3a; *(vec *) (c + 3 * ldc + h) += c3b;       \
+    *(vec *) (c + 4 * ldc) += c4a; *(vec *) (c + 4 * ldc + h) += c4b;       \
+    *(vec *) (c + 5 * ldc) += c5a; *(vec *) (c + 5 * ldc + h) += c5b;       \
+  }
+
+#ifdef X86
+#define SSE2 __attribute__((target("sse2")))
+#define AVX2 __attribute__((target("avx2")))
+#define AVX512 __attribute__((target("avx512f")))
+DEFINE_MICRO_KERNEL(int, gemm, sse2, SSE2, 16)
+DEFINE_MICRO_KERNEL(float, fgemm, sse2, SSE2, 16)
+DEFINE_MICRO_KERNEL(int, gemm, avx2, AVX2, 32)
+DEFINE_MICRO_KERNEL(float, fgemm, avx2, AVX2, 32)
+DEFINE_MICRO_KERNEL(int, gemm, avx512, AVX512, 64)
+DEFINE_MICRO_KERNEL(float, fgemm, avx512, AVX512, 64)
+#else
+DEFINE_MICRO_KERNEL(int, gemm, scalar, , 16)
+DEFINE_MICRO_KERNEL(float, fgemm, scalar, , 16)
+#endif
+
+gemm_kernel_t gemm_kernels[] =
+{
+#ifdef X86
+  {"sse2",   8,  gemm_kernel_sse2,   fgemm_kernel_sse2},
+  {"avx2",   16, gemm_kernel_avx2,   fgemm_kernel_avx2},
+  {"avx512", 32, gemm_kernel_avx512, fgemm_kernel_avx512},
+#else
+  {"scalar", 8,  gemm_kernel_scalar, fgemm_kernel_scalar},
+#endif
+  {NULL}
+};
+
+/// The kernel selected at startup.
+static gemm_kernel_t *best = gemm_kernels;
+
+/// Select the fastest supported kernel before main starts.
+__attribute__((constructor))
+static void gemm_init()
+{
+  for(gemm_kernel_t *k = gemm_kernels; k->name; k++)
+    if (isa_supported(k->name))
+      best = k;
+}
+
+gemm_kernel_t *gemm_best()
+{
+  return best;
+}
+
+/// Define gemm (or fgemm) and its helpers for elements of type T.
+/// @param T Element type.
+/// @param NAME Name of the multiplication.
+/// @param MATRIX Matrix type.
+/// @param KERNEL Field of gemm_kernel_t holding the micro-kernel.
+#define DEFINE_GEMM(T, NAME, MATRIX, KERNEL)                                \
+  void NAME##_naive(MATRIX *c, MATRIX *a, MATRIX *b)                        \
+  {                                                                         \
+    for(long i = 0; i < c->rows; i++)                                       \
+      for(long j = 0; j < c->cols; j++)                                     \
+      {                                                                     \
+        T sum = 0;                                                          \
+        for(long k = 0; k < a->cols; k++)                                   \
+          sum += MATRIX_AT(a, i, k) * MATRIX_AT(b, k, j);                   \
+        MATRIX_AT(c, i, j) = sum;                                           \
+      }                                                                     \
+  }                                                                         \
+                                                                            \
+  /* Pack rows [i0, i0 + mc) x columns [p0, p0 + kc) of a into panels */    \
+  /* of GEMM_MR rows, column by column. Missing rows are zeros. */          \
+  static void NAME##_pack_a(T *pack, MATRIX *a, long i0, long mc,           \
+                            long p0, long kc)                               \
+  {                                                                         \
+    for(long ir = 0; ir < mc; ir += GEMM_MR)                                \
+      for(long p = 0; p < kc; p++)                                          \
+        for(long r = 0; r < GEMM_MR; r++)                                   \
+          *pack++ = (ir + r < mc) ? MATRIX_AT(a, i0 + ir + r, p0 + p) : 0;  \
+  }                                                                         \
+                                                                            \
+  /* Pack rows [p0, p0 + kc) x columns [j0, j0 + nc) of b into panels */    \
+  /* of nr columns, row by row. Missing columns are zeros. */               \
+  static void NAME##_pack_b(T *pack, MATRIX *b, long p0, long kc,           \
+                            long j0, long nc, long nr)                      \
+  {                                                                         \
+    for(long jr = 0; jr < nc; jr += nr)                                     \
+      for(long p = 0; p < kc; p++)                                          \
+      {                                                                     \
+        T *row = &MATRIX_AT(b, p0 + p, j0 + jr);                            \
+        for(long j = 0; j < nr; j++)                                        \
+          *pack++ = (jr + j < nc) ? row[j] : 0;                             \
+      }                                                                     \
+  }                                                                         \
+                                                                            \
+  /* A packed block of B, shared by the workers. */                         \
+  typedef struct                                                            \
+  {                                                                         \
+    worker_pool_t *pool;                                                    \
+    MATRIX *c, *a;                                                          \
+    T *b_pack;                                                              \
+    T **a_packs;   /* One per worker */                                     \
+    long j0, nc, p0, kc;                                                    \
+  } NAME##_block_t;                                                         \
+                                                                            \
+  /* Multiply the blocks of GEMM_MC rows of A of worker id by the */        \
+  /* packed block of B. */                                                  \
+  static void NAME##_worker(void *arg, int id)                              \
+  {                                                                         \
+    NAME##_block_t *blk = arg;                                              \
+    MATRIX *c = blk->c;                                                     \
+    T *a_pack = blk->a_packs[id];                                           \
+    long nr = best->nr, kc = blk->kc;                                       \
+    long blocks = (c->rows + GEMM_MC - 1) / GEMM_MC;                        \
+    long first, last;                                                       \
+                                                                            \
+    worker_pool_range(blk->pool, id, blocks, &first, &last);                \
+    for(long ib = first; ib < last; ib++)                                   \
+    {                                                                       \
+      long i0 = ib * GEMM_MC;                                               \
+      long mc = (c->rows - i0 < GEMM_MC) ? c->rows - i0 : GEMM_MC;          \
+                                                                            \
+      NAME##_pack_a(a_pack, blk->a, i0, mc, blk->p0, kc);                   \
+      for(long jr = 0; jr < blk->nc; jr += nr)                              \
+        for(long ir = 0; ir < mc; ir += GEMM_MR)                            \
+        {                                                                   \
+          T *a_panel = a_pack + ir * kc, *b_panel = blk->b_pack + jr * kc;  \
+          T *tile = &MATRIX_AT(c, i0 + ir, blk->j0 + jr);                   \
+          long rows = (mc - ir < GEMM_MR) ? mc - ir : GEMM_MR;              \
+          long cols = (blk->nc - jr < nr) ? blk->nc - jr : nr;              \
+                                                                            \
+          if (rows == GEMM_MR && cols == nr)                                \
+            best->KERNEL(kc, a_panel, b_panel, tile, c->stride);            \
+          else                                                              \
+          {                                                                 \
+            /* Edge tile: compute it aside, add its valid part */           \
+            T part[GEMM_MR * GEMM_NR_MAX] __attribute__((aligned(64)));     \
+            memset(part, 0, sizeof(part));                                  \
+            best->KERNEL(kc, a_panel, b_panel, part, nr);                   \
+            for(long r = 0; r < rows; r++)                                  \
+              for(long j = 0; j < cols; j++)                                \
+                tile[r * c->stride + j] += part[r * nr + j];                \
+          }                                                                 \
+        }                                                                   \
+    }                                                                       \
+  }                                                                         \
+                                                                            \
+  void NAME(worker_pool_t *pool, MATRIX *c, MATRIX *a, MATRIX *b)           \
+  {                                                                         \
+    long nr = best->nr;                                                     \
+    NAME##_block_t blk = {pool, c, a};                                      \
+                                                                            \
+    for(long i = 0; i < c->rows; i++)                                       \
+      memset(&MATRIX_AT(c, i, 0), 0, c->cols * sizeof(T));                  \
+    blk.b_pack = aligned_alloc(64, GEMM_KC * GEMM_NC * sizeof(T));          \
+    blk.a_packs = malloc(pool->n_workers * sizeof(T *));                    \
+    for(int id = 0; id < pool->n_workers; id++)                             \
+      blk.a_packs[id] = aligned_alloc(64, GEMM_MC * GEMM_KC * sizeof(T));   \
+                                                                            \
+    for(blk.j0 = 0; blk.j0 < b->cols; blk.j0 += GEMM_NC)                    \
+    {                                                                       \
+      blk.nc = (b->cols - blk.j0 < GEMM_NC) ? b->cols - blk.j0 : GEMM_NC;   \
+      for(blk.p0 = 0; blk.p0 < a->cols; blk.p0 += GEMM_KC)                  \
+      {                                                                     \
+        blk.kc = (a->cols - blk.p0 < GEMM_KC) ? a->cols - blk.p0 : GEMM_KC; \
+        NAME##_pack_b(blk.b_pack, b, blk.p0, blk.kc, blk.j0, blk.nc, nr);   \
+        worker_pool_run(pool, NAME##_worker, &blk);                         \
+      }                                                                     \
+    }                                                                       \
+                                                                            \
+    for(int id = 0; id < pool->n_workers; id++)                             \
+      free(blk.a_packs[id]);                                                \
+    free(blk.a_packs);                                                      \
+    free(blk.b_pack);                                                       \
+  }
+
+DEFINE_GEMM(int, gemm, matrix_t, ikernel)
+DEFINE_GEMM(float, fgemm, fmatrix_t, fkernel)
@@ -0,0 +1,52 @@
+#ifndef GEMM_H
+#define GEMM_H
+
+#include "matrix.h"
+#include "worker_pool.h"
+
+/// Rows of the micro-kernel tile of C.
+#define GEMM_MR 6
+
+/// Depth of a packed panel: a KC x NR panel of B stays in the L1
+/// cache while the micro-kernel walks it.
+#define GEMM_KC 256
+
+/// Rows of the packed block of A (72 KB of floats), kept in the L2
+/// cache while it is multiplied by the whole packed block of B.
+#define GEMM_MC 72
+
+/// Columns of the packed block of B (4 MB of floats), kept in the
+/// last level cache.
+#define GEMM_NC 4096
+
+/// Micro-kernels written for one instruction set. A micro-kernel adds
+/// to a GEMM_MR x nr tile of C the product of a packed GEMM_MR x kc
+/// panel of A and a packed kc x nr panel of B, the whole tile being
+/// held in vector registers (2 vectors per row).
+typedef struct
+{
+  /// Name of the instruction set ("sse2", "avx2", "avx512").
+  char *name;
+  /// Columns of the tile of C (2 vectors).
+  long nr;
+  void (*ikernel)(long kc, int *a, int *b, int *c, long ldc);
+  void (*fkernel)(long kc, float *a, float *b, float *c, long ldc);
+} gemm_kernel_t;
+
+/// The kernels compiled in, from the most portable to the fastest.
+/// The table is terminated by an entry with a NULL name.
+extern gemm_kernel_t gemm_kernels[];
+
+/// @return The fastest kernel supported by the processor.
+gemm_kernel_t *gemm_best();
+
+/// Store a . b in c with the naive triple loop.
+void gemm_naive(matrix_t *c, matrix_t *a, matrix_t *b);
+void fgemm_naive(fmatrix_t *c, fmatrix_t *a, fmatrix_t *b);
+
+/// Store a . b in c. A and B are packed block by block into panels
+/// laid out in the order the micro-kernel reads them. The blocks of
+/// GEMM_MC rows of C are shared among the workers of pool.
+void gemm(worker_pool_t *pool, matrix_t *c, matrix_t *a, matrix_t *b);
+void fgemm(worker_pool_t *pool, fmatrix_t *c, fmatrix_t *a, fmatrix_t *b);
+#endif
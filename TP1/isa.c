@@ -0,0 +1,17 @@
+#include <string.h>
+
+#include "isa.h"
+
+int isa_supported(char *isa)
+{
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_cpu_init();
+  if (strcmp(isa, "sse2") == 0)
+    return __builtin_cpu_supports("sse2");
+  if (strcmp(isa, "avx2") == 0)
+    return __builtin_cpu_supports("avx2");
+  if (strcmp(isa, "avx512") == 0)
+    return __builtin_cpu_supports("avx512f");
+#endif
+  return strcmp(isa, "scalar") == 0;
+}
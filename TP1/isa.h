@@ -0,0 +1,16 @@
+#ifndef ISA_H
+#define ISA_H
+
+/// @param isa An instruction set: "scalar", "sse2", "avx2" or "avx512"
+/// (AVX-512 F).
+/// @return Whether the processor supports isa.
+int isa_supported(char *isa);
+
+/// Keep the scalar kernels scalar, so that they remain a baseline
+/// for the vector ones whatever the optimization level.
+#if defined(__GNUC__) && !defined(__clang__)
+#define SCALAR __attribute__((optimize("no-tree-vectorize")))
+#else
+#define SCALAR
+#endif
+#endif
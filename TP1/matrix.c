@@ -0,0 +1,265 @@
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "matrix.h"
+#include "output.h"
+#include "rng.h"
+
+/// Size of a huge page on x86-64 Linux.
+#define HUGE_PAGE_SIZE (2L << 20)
+
+/// @return n rounded up to a multiple of align.
+static long round_up(long n, long align)
+{
+  return (n + align - 1) / align * align;
+}
+
+/// Map size bytes backed by huge pages: reserved ones (hugetlbfs) if
+/// any, transparent ones otherwise.
+/// @return The mapping, NULL if it failed.
+static void *map_huge_pages(size_t size)
+{
+  void *p = MAP_FAILED;
+
+#ifdef MAP_HUGETLB
+  p = mmap(NULL, size, PROT_READ | PROT_WRITE,
+           MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+  if (p == MAP_FAILED)
+  {
+    p = mmap(NULL, size, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED)
+      return NULL;
+#ifdef MADV_HUGEPAGE
+    madvise(p, size, MADV_HUGEPAGE);
+#endif
+  }
+  return p;
+}
+
+/// Allocate the zeroed data of a rows x cols matrix of elements of
+/// size bytes, and set its stride, size and mapped fields.
+/// @return The data, NULL if memory is exhausted.
+static void *matrix_data_alloc(long rows, long cols, size_t size, int flags,
+                               long *stride, size_t *bytes, int *mapped)
+{
+  void *data;
+
+  *stride = round_up(cols, MATRIX_ALIGN / size);
+  *bytes = round_up(rows * *stride * size, MATRIX_ALIGN);
+  *mapped = (flags & MATRIX_HUGE_PAGES) != 0;
+
+  if (*mapped)
+  {
+    // Anonymous mappings are already filled with zeros
+    *bytes = round_up(*bytes, HUGE_PAGE_SIZE);
+    return map_huge_pages(*bytes);
+  }
+  data = aligned_alloc(MATRIX_ALIGN, (*bytes > 0) ? *bytes : MATRIX_ALIGN);
+  if (data != NULL)
+    memset(data, 0, *bytes);
+  return data;
+}
+
+/// Release data allocated by matrix_data_alloc.
+static void matrix_data_free(void *data, size_t bytes, int mapped)
+{
+  if (mapped)
+    munmap(data, bytes);
+  else
+    free(data);
+}
+
+matrix_t *matrix_alloc(long rows, long cols, int flags)
+{
+  matrix_t *m = malloc(sizeof(matrix_t));
+
+  if (m == NULL)
+    return NULL;
+  m->rows = rows;
+  m->cols = cols;
+  m->data = matrix_data_alloc(rows, cols, sizeof(int), flags,
+                              &m->stride, &m->size, &m->mapped);
+  if (m->data == NULL)
+  {
+    free(m);
+    return NULL;
+  }
+  return m;
+}
+
+void matrix_free(matrix_t *m)
+{
+  matrix_data_free(m->data, m->size, m->mapped);
+  free(m);
+}
+
+fmatrix_t *fmatrix_alloc(long rows, long cols, int flags)
+{
+  fmatrix_t *m = malloc(sizeof(fmatrix_t));
+
+  if (m == NULL)
+    return NULL;
+  m->rows = rows;
+  m->cols = cols;
+  m->data = matrix_data_alloc(rows, cols, sizeof(float), flags,
+                              &m->stride, &m->size, &m->mapped);
+  if (m->data == NULL)
+  {
+    free(m);
+    return NULL;
+  }
+  return m;
+}
+
+void fmatrix_free(fmatrix_t *m)
+{
+  matrix_data_free(m->data, m->size, m->mapped);
+  free(m);
+}
+
+int *matrix_row(matrix_t *m, long i)
+{
+  return m->data + i * m->stride;
+}
+
+void matrix_init_rand(matrix_t *m)
+{
+  for(long i = 0; i < m->rows; i++)
+    rng_fill(matrix_row(m, i), m->cols, 5, MATRIX_SEED, i * m->cols);
+}
+
+void fmatrix_init_rand(fmatrix_t *m)
+{
+  for(long i = 0; i < m->rows; i++)
+    rng_ffill(&MATRIX_AT(m, i, 0), m->cols, 5, MATRIX_SEED, i * m->cols);
+}
+
+/// A parallel fill of a matrix_t (or fmatrix_t if f is set), shared
+/// by the workers.
+typedef struct
+{
+  worker_pool_t *pool;
+  matrix_t *m;
+  fmatrix_t *f;
+  uint64_t seed;
+} matrix_fill_t;
+
+/// Fill the rows of worker id.
+static void matrix_fill_worker(void *arg, int id)
+{
+  matrix_fill_t *fill = arg;
+  matrix_t *m = fill->m;
+  fmatrix_t *f = fill->f;
+  long rows = (f != NULL) ? f->rows : m->rows;
+  long first, last;
+
+  worker_pool_range(fill->pool, id, rows, &first, &last);
+  for(long i = first; i < last; i++)
+    if (f != NULL)
+      rng_ffill(&MATRIX_AT(f, i, 0), f->cols, 5, fill->seed, i * f->cols);
+    else
+      rng_fill(matrix_row(m, i), m->cols, 5, fill->seed, i * m->cols);
+}
+
+void matrix_fill_rand(worker_pool_t *pool, matrix_t *m, uint64_t seed)
+{
+  matrix_fill_t fill = {pool, m, NULL, seed};
+
+  worker_pool_run(pool, matrix_fill_worker, &fill);
+}
+
+void fmatrix_fill_rand(worker_pool_t *pool, fmatrix_t *m, uint64_t seed)
+{
+  matrix_fill_t fill = {pool, NULL, m, seed};
+
+  worker_pool_run(pool, matrix_fill_worker, &fill);
+}
+
+void matrix_print(matrix_t *m)
+{
+  fflush(stdout);
+  for(long i = 0; i < m->rows; i++)
+  {
+    for(long j = 0; j < m->cols; j++)
+    {
+      output_int(STDOUT_FILENO, MATRIX_AT(m, i, j), 3);
+      output_string(STDOUT_FILENO, " ");
+    }
+    output_string(STDOUT_FILENO, "\n");
+  }
+  output_flush();
+}
+
+void vector_print(int *v, long n)
+{
+  fflush(stdout);
+  output_string(STDOUT_FILENO, "(");
+  for(long i = 0; i < n; i++)
+  {
+    output_int(STDOUT_FILENO, v[i], 0);
+    output_string(STDOUT_FILENO, (i == n - 1) ? ")\n" : " ");
+  }
+  output_flush();
+}
+
+int matrix_dump(matrix_t *m, int fd)
+{
+  int64_t header[2] = {m->rows, m->cols};
+  struct iovec rows[MATRIX_DUMP_ROWS];
+
+  if (output_write(fd, header, sizeof(header)) < 0)
+    return -1;
+  // The rows are not contiguous (padding): gather a batch per write
+  for(long i = 0; i < m->rows; i += MATRIX_DUMP_ROWS)
+  {
+    long n = (m->rows - i < MATRIX_DUMP_ROWS) ? m->rows - i : MATRIX_DUMP_ROWS;
+    for(long k = 0; k < n; k++)
+    {
+      rows[k].iov_base = matrix_row(m, i + k);
+      rows[k].iov_len = m->cols * sizeof(int);
+    }
+    ssize_t written = writev(fd, rows, n);
+    if (written < 0 && errno != EINTR)
+      return -1;
+    if (written < 0)
+      written = 0;
+    // Finish a partial write row by row
+    for(long k = 0; k < n; k++)
+    {
+      size_t done = ((size_t) written < rows[k].iov_len) ? written
+                                                        : rows[k].iov_len;
+      written -= done;
+      if (done < rows[k].iov_len &&
+          output_write(fd, (char *) rows[k].iov_base + done,
+                       rows[k].iov_len - done) < 0)
+        return -1;
+    }
+  }
+  return 0;
+}
+
+int vector_dump(int *v, long n, int fd)
+{
+  int64_t header = n;
+
+  if (output_write(fd, &header, sizeof(header)) < 0)
+    return -1;
+  return output_write(fd, v, n * sizeof(int));
+}
+
+int *vector_alloc(long n)
+{
+  size_t size = round_up(n * sizeof(int), MATRIX_ALIGN);
+  int *v = aligned_alloc(MATRIX_ALIGN, (size > 0) ? size : MATRIX_ALIGN);
+
+  if (v != NULL)
+    memset(v, 0, size);
+  return v;
+}
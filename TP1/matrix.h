@@ -0,0 +1,113 @@
+#ifndef MATRIX_H
+#define MATRIX_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "worker_pool.h"
+
+/// Alignment in bytes of matrices and vectors: a cache line, and the
+/// width of the widest SIMD registers (AVX-512).
+#define MATRIX_ALIGN 64
+
+/// Flag of matrix_alloc: back the matrix with huge pages when the
+/// system provides them, to save TLB misses on large matrices.
+#define MATRIX_HUGE_PAGES 1
+
+/// Rows written by each writev of matrix_dump (at most IOV_MAX).
+#define MATRIX_DUMP_ROWS 256
+
+/// Seed of matrix_init_rand and fmatrix_init_rand.
+#define MATRIX_SEED 1
+
+/// Matrix of integers of runtime size, stored row-major. Each row
+/// starts on a MATRIX_ALIGN boundary: stride is cols rounded up to a
+/// multiple of MATRIX_ALIGN / sizeof(int), and the padding elements
+/// are zero.
+typedef struct
+{
+  long rows;
+  long cols;
+  long stride;    ///< Distance in elements between two rows
+  int *data;      ///< rows * stride elements
+  size_t size;    ///< Size in bytes of the allocated block
+  int mapped;     ///< Whether data was mapped (huge pages) or allocated
+} matrix_t;
+
+/// Matrix of floats, with the same layout as matrix_t.
+typedef struct
+{
+  long rows;
+  long cols;
+  long stride;    ///< Distance in elements between two rows
+  float *data;    ///< rows * stride elements
+  size_t size;    ///< Size in bytes of the allocated block
+  int mapped;     ///< Whether data was mapped (huge pages) or allocated
+} fmatrix_t;
+
+/// Element (i, j) of matrix m (matrix_t or fmatrix_t).
+#define MATRIX_AT(m, i, j) ((m)->data[(i) * (m)->stride + (j)])
+
+/// Allocate a rows x cols matrix filled with zeros.
+/// @param flags 0 or MATRIX_HUGE_PAGES.
+/// @return The new matrix, NULL if memory is exhausted.
+matrix_t *matrix_alloc(long rows, long cols, int flags);
+
+/// Free a matrix allocated by matrix_alloc.
+void matrix_free(matrix_t *m);
+
+/// @param i A row index.
+/// @return The first element of row i of m.
+int *matrix_row(matrix_t *m, long i);
+
+/// Initialize a given matrix with random values (module 5), drawn
+/// from the stream of MATRIX_SEED.
+void matrix_init_rand(matrix_t *m);
+
+/// Initialize a given matrix with random values (module 5), the rows
+/// being shared among the workers of pool. Element (i, j) is element
+/// i * cols + j of the stream of seed (see rng.h), so the matrix does
+/// not depend on the number of workers.
+void matrix_fill_rand(worker_pool_t *pool, matrix_t *m, uint64_t seed);
+
+/// Print the elements of a matrix, buffered (see output.h).
+void matrix_print(matrix_t *m);
+
+/// Write a matrix to file fd in binary for machine comparison: rows
+/// and cols as two int64_t, then the rows * cols elements row by row,
+/// without padding, in the byte order of the machine.
+/// @return 0 on success, -1 on error.
+int matrix_dump(matrix_t *m, int fd);
+
+/// Allocate a rows x cols float matrix filled with zeros.
+/// @param flags 0 or MATRIX_HUGE_PAGES.
+/// @return The new matrix, NULL if memory is exhausted.
+fmatrix_t *fmatrix_alloc(long rows, long cols, int flags);
+
+/// Free a matrix allocated by fmatrix_alloc.
+void fmatrix_free(fmatrix_t *m);
+
+/// Initialize a given float matrix with random integral values
+/// (module 5), so that sums of products are exact.
+void fmatrix_init_rand(fmatrix_t *m);
+
+/// Same as matrix_fill_rand for a float matrix.
+void fmatrix_fill_rand(worker_pool_t *pool, fmatrix_t *m, uint64_t seed);
+
+/// Allocate a vector of n integers aligned on MATRIX_ALIGN, filled
+/// with zeros.
+/// @return The new vector, to be released by free, NULL if memory is
+/// exhausted.
+int *vector_alloc(long n);
+
+/// Print the value of each element of a vector, buffered (see
+/// output.h).
+/// @param v The vector to print.
+/// @param n Size of the vector.
+void vector_print(int *v, long n);
+
+/// Write a vector to file fd in binary: n as an int64_t, then the n
+/// elements.
+/// @return 0 on success, -1 on error.
+int vector_dump(int *v, long n, int fd);
+#endif
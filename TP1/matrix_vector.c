@@ -0,0 +1,184 @@
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define X86 1
+#endif
+
+#include "isa.h"
+#include "matrix_vector.h"
+
+/// Scalar kernel: one dot product at a time.
+SCALAR static void rows_scalar(int *y, int *m, long rows, long stride,
+                               int *v, long n)
+{
+  for(long i = 0; i < rows; i++)
+  {
+    int sum = 0;
+    for(long j = 0; j < n; j++)
+      sum += m[i * stride + j] * v[j];
+    y[i] += sum;
+  }
+}
+
+#ifdef X86
+/// @return The sum of the 8 lanes of s.
+__attribute__((target("avx2")))
+static inline int hsum_avx2(__m256i s)
+{
+  __m128i h = _mm_add_epi32(_mm256_castsi256_si128(s),
+                            _mm256_extracti128_si256(s, 1));
+  h = _mm_add_epi32(h, _mm_shuffle_epi32(h, _MM_SHUFFLE(1, 0, 3, 2)));
+  h = _mm_add_epi32(h, _mm_shuffle_epi32(h, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(h);
+}
+
+/// Define the kernel of an instruction set. Rows are multiplied
+/// MATRIX_VECTOR_ROW_BLOCK at a time, each with its own accumulator,
+/// so that each vector of v is loaded once for all of them.
+/// @param ISA Name of the instruction set.
+/// @param TARGET Target attribute enabling the instruction set.
+/// @param VEC Vector type.
+/// @param ZERO, LOAD, ADD, MUL, HSUM Zero vector, unaligned load,
+/// 32-bit addition and multiplication, horizontal sum of VEC.
+#define DEFINE_MATRIX_VECTOR_KERNEL(ISA, TARGET, VEC, ZERO, LOAD, ADD, MUL,  \
+                                    HSUM)                                   \
+  __attribute__((target(TARGET)))                                          \
+  static void rows_##ISA(int *y, int *m, long rows, long stride,          \
+                         int *v, long n)                                    \
+  {                                                                         \
+    long w = sizeof(VEC) / sizeof(int);                                     \
+    long i = 0, j;                                                          \
+                                                                            \
+    for(; i + MATRIX_VECTOR_ROW_BLOCK <= rows;                              \
+        i += MATRIX_VECTOR_ROW_BLOCK)                                       \
+    {                                                                       \
+      int *mi = m + i * stride;                                             \
+      VEC s[MATRIX_VECTOR_ROW_BLOCK];                                       \
+      int t[MATRIX_VECTOR_ROW_BLOCK], r;                                    \
+                                                                            \
+      for(r = 0; r < MATRIX_VECTOR_ROW_BLOCK; r++)                          \
+        s[r] = ZERO();                                                      \
+      for(j = 0; j + w <= n; j += w)                                        \
+      {                                                                     \
+        VEC x = LOAD((VEC *) (v + j));                                      \
+        for(r = 0; r < MATRIX_VECTOR_ROW_BLOCK; r++)                        \
+          s[r] = ADD(s[r], MUL(LOAD((VEC *) (mi + r * stride + j)), x));    \
+      }                                                                     \
+      for(r = 0; r < MATRIX_VECTOR_ROW_BLOCK; r++)                          \
+        t[r] = HSUM(s[r]);                                                  \
+      for(; j < n; j++)                                                     \
+        for(r = 0; r < MATRIX_VECTOR_ROW_BLOCK; r++)                        \
+          t[r] += mi[r * stride + j] * v[j];                                \
+      for(r = 0; r < MATRIX_VECTOR_ROW_BLOCK; r++)                          \
+        y[i + r] += t[r];                                                   \
+    }                                                                       \
+    for(; i < rows; i++)                                                    \
+    {                                                                       \
+      int *m0 = m + i * stride;                                             \
+      VEC s0 = ZERO();                                                      \
+                                                                            \
+      for(j = 0; j + w <= n; j += w)                                        \
+        s0 = ADD(s0, MUL(LOAD((VEC *) (m0 + j)), LOAD((VEC *) (v + j))));   \
+      int y0 = HSUM(s0);                                                    \
+      for(; j < n; j++)                                                     \
+        y0 += m0[j] * v[j];                                                 \
+      y[i] += y0;                                                           \
+    }                                                                       \
+  }
+
+DEFINE_MATRIX_VECTOR_KERNEL(avx2, "avx2", __m256i, _mm256_setzero_si256,
+                            _mm256_loadu_si256, _mm256_add_epi32,
+                            _mm256_mullo_epi32, hsum_avx2)
+DEFINE_MATRIX_VECTOR_KERNEL(avx512, "avx512f", __m512i, _mm512_setzero_si512,
+                            _mm512_loadu_si512, _mm512_add_epi32,
+                            _mm512_mullo_epi32, _mm512_reduce_add_epi32)
+#endif
+
+/// SSE2 has no 32-bit multiplication (it comes with SSE4.1), hence no
+/// SSE2 kernel.
+matrix_vector_kernel_t matrix_vector_kernels[] =
+{
+  {"scalar", rows_scalar},
+#ifdef X86
+  {"avx2",   rows_avx2},
+  {"avx512", rows_avx512},
+#endif
+  {NULL}
+};
+
+/// The kernel selected at startup.
+static matrix_vector_kernel_t *best = matrix_vector_kernels;
+
+/// Select the fastest supported kernel before main starts.
+__attribute__((constructor))
+static void matrix_vector_init()
+{
+  for(matrix_vector_kernel_t *k = matrix_vector_kernels; k->name; k++)
+    if (isa_supported(k->name))
+      best = k;
+}
+
+matrix_vector_kernel_t *matrix_vector_best()
+{
+  return best;
+}
+
+/// Multiply the rows x cols matrix starting at m, of stride elements
+/// per row, with v.
+static void product(matrix_vector_kernel_t *k, int *y, int *m,
+                    long rows, long cols, long stride, int *v)
+{
+  for(long i = 0; i < rows; i++)
+    y[i] = 0;
+  for(long j = 0; j < cols; j += MATRIX_VECTOR_COL_BLOCK)
+  {
+    long n = (cols - j < MATRIX_VECTOR_COL_BLOCK) ? cols - j
+      : MATRIX_VECTOR_COL_BLOCK;
+    k->rows(y, m + j, rows, stride, v + j, n);
+  }
+}
+
+void matrix_vector_kernel(matrix_vector_kernel_t *k, int *y, matrix_t *m,
+                          int *v)
+{
+  product(k, y, m->data, m->rows, m->cols, m->stride, v);
+}
+
+void matrix_vector(int *y, matrix_t *m, int *v)
+{
+  product(best, y, m->data, m->rows, m->cols, m->stride, v);
+}
+
+/// A parallel product, shared by the workers.
+typedef struct
+{
+  worker_pool_t *pool;
+  int *y;
+  matrix_t *m;
+  int *v;
+} matrix_vector_t;
+
+/// Compute the rows of worker id. Parts are rounded to whole row
+/// blocks, so that only the last part has leftover rows.
+static void matrix_vector_worker(void *arg, int id)
+{
+  matrix_vector_t *p = arg;
+  matrix_t *m = p->m;
+  long blocks = (m->rows + MATRIX_VECTOR_ROW_BLOCK - 1) / MATRIX_VECTOR_ROW_BLOCK;
+  long first, last;
+
+  worker_pool_range(p->pool, id, blocks, &first, &last);
+  first *= MATRIX_VECTOR_ROW_BLOCK;
+  last *= MATRIX_VECTOR_ROW_BLOCK;
+  if (last > m->rows)
+    last = m->rows;
+  if (first < last)
+    product(best, p->y + first, matrix_row(m, first), last - first,
+            m->cols, m->stride, p->v);
+}
+
+void parallel_matrix_vector(worker_pool_t *pool, int *y, matrix_t *m, int *v)
+{
+  matrix_vector_t p = {pool, y, m, v};
+
+  worker_pool_run(pool, matrix_vector_worker, &p);
+}
@@ -0,0 +1,46 @@
+#ifndef MATRIX_VECTOR_H
+#define MATRIX_VECTOR_H
+
+#include "matrix.h"
+#include "worker_pool.h"
+
+/// Number of columns processed at once: the block of v (16 KB) stays
+/// in the L1 cache while it is multiplied by every row.
+#define MATRIX_VECTOR_COL_BLOCK 4096
+
+/// Number of rows multiplied at once, so that each element of v loaded
+/// in a register serves several rows.
+#define MATRIX_VECTOR_ROW_BLOCK 4
+
+/// Matrix vector product kernels written for one instruction set.
+typedef struct
+{
+  /// Name of the instruction set ("scalar", "avx2", "avx512").
+  char *name;
+  /// Add to y[0..rows-1] the products of rows rows of m (of stride
+  /// elements each) by the n first elements of v.
+  void (*rows)(int *y, int *m, long rows, long stride, int *v, long n);
+} matrix_vector_kernel_t;
+
+/// The kernels compiled in, from the most portable to the fastest.
+/// The table is terminated by an entry with a NULL name.
+extern matrix_vector_kernel_t matrix_vector_kernels[];
+
+/// @return The fastest kernel supported by the processor.
+matrix_vector_kernel_t *matrix_vector_best();
+
+/// Multiply matrix m with vector v and store the result in y, with
+/// kernel k.
+/// @param y The result vector, of m->rows elements.
+/// @param m The input matrix.
+/// @param v The input vector, of m->cols elements.
+void matrix_vector_kernel(matrix_vector_kernel_t *k, int *y, matrix_t *m,
+                          int *v);
+
+/// Same as matrix_vector_kernel with the fastest kernel.
+void matrix_vector(int *y, matrix_t *m, int *v);
+
+/// Same as matrix_vector, each worker of pool computing a contiguous
+/// part of the rows.
+void parallel_matrix_vector(worker_pool_t *pool, int *y, matrix_t *m, int *v);
+#endif
@@ -0,0 +1,94 @@
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "output.h"
+
+/// Longest decimal int: sign and 10 digits.
+#define INT_DIGITS 11
+
+/// Buffer of the calling thread, its number of bytes used and the
+/// file it is written to.
+static __thread char buffer[OUTPUT_BUFFER_SIZE];
+static __thread size_t used;
+static __thread int buffer_fd = -1;
+
+int output_write(int fd, const void *data, size_t size)
+{
+  const char *p = data;
+
+  while (size > 0)
+  {
+    ssize_t n = write(fd, p, size);
+    if (n < 0)
+    {
+      if (errno == EINTR)
+        continue;
+      return -1;
+    }
+    p += n;
+    size -= n;
+  }
+  return 0;
+}
+
+int output_flush()
+{
+  int status = 0;
+
+  if (used > 0)
+    status = output_write(buffer_fd, buffer, used);
+  used = 0;
+  return status;
+}
+
+/// Make room for size bytes (at most OUTPUT_BUFFER_SIZE) for file fd
+/// in the buffer of the calling thread.
+/// @return Where to append them.
+static char *reserve(int fd, size_t size)
+{
+  if (fd != buffer_fd || used + size > OUTPUT_BUFFER_SIZE)
+  {
+    output_flush();
+    buffer_fd = fd;
+  }
+  return buffer + used;
+}
+
+void output_string(int fd, const char *s)
+{
+  size_t length = strlen(s);
+
+  while (length > 0)
+  {
+    size_t n = (length < OUTPUT_BUFFER_SIZE) ? length : OUTPUT_BUFFER_SIZE;
+    memcpy(reserve(fd, n), s, n);
+    used += n;
+    s += n;
+    length -= n;
+  }
+}
+
+void output_int(int fd, int x, int width)
+{
+  char digits[INT_DIGITS];
+  char *end = digits + INT_DIGITS, *p = end;
+  unsigned u = (x < 0) ? -(unsigned) x : (unsigned) x;
+
+  // Digits from the least significant one
+  do
+  {
+    *--p = '0' + u % 10;
+    u /= 10;
+  } while (u != 0);
+  if (x < 0)
+    *--p = '-';
+
+  long length = end - p;
+  long pad = (width > length) ? width - length : 0;
+  char *out = reserve(fd, pad + length);
+
+  memset(out, ' ', pad);
+  memcpy(out + pad, p, length);
+  used += pad + length;
+}
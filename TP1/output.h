@@ -0,0 +1,28 @@
+#ifndef OUTPUT_H
+#define OUTPUT_H
+
+#include <stddef.h>
+
+/// Size in bytes of the output buffer of each thread.
+#define OUTPUT_BUFFER_SIZE (64 << 10)
+
+/// Buffered output for large dumps: text is formatted into a buffer
+/// of the calling thread, without stdio, and written with a single
+/// write() per OUTPUT_BUFFER_SIZE bytes. Whatever stdio holds for the
+/// same file must be flushed first (fflush) to keep the order.
+
+/// Append s to the buffer of the calling thread for file fd.
+void output_string(int fd, const char *s);
+
+/// Append x in decimal, right-aligned on width characters, to the
+/// buffer of the calling thread for file fd.
+void output_int(int fd, int x, int width);
+
+/// Write the buffer of the calling thread to its file.
+/// @return 0 on success, -1 on error.
+int output_flush();
+
+/// Write size bytes of data to fd, resuming partial writes.
+/// @return 0 on success, -1 on error.
+int output_write(int fd, const void *data, size_t size);
+#endif
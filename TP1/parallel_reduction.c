@@ -0,0 +1,106 @@
+#include <limits.h>
+#include <stdlib.h>
+
+#include "parallel_reduction.h"
+#include "vector_reduction.h"
+
+/// Define the chunk kernel and the combine function of an operator.
+/// The kernel keeps 4 independent accumulators so that the compiler
+/// can vectorize it.
+/// @param NAME Name of the operator.
+/// @param IDENTITY Neutral element.
+/// @param STEP(acc, x) Fold element x into accumulator acc.
+/// @param COMBINE(x, y) Combine two accumulators.
+#define DEFINE_REDUCTION(NAME, IDENTITY, STEP, COMBINE)                 \
+  static long NAME##_combine(long x, long y)                           \
+  {                                                                     \
+    return COMBINE(x, y);                                               \
+  }                                                                     \
+                                                                        \
+  static long NAME##_chunk(int *a, long n)                              \
+  {                                                                     \
+    long s0 = IDENTITY, s1 = IDENTITY, s2 = IDENTITY, s3 = IDENTITY;    \
+    long i = 0;                                                         \
+    for(; i + 4 <= n; i += 4)                                           \
+    {                                                                   \
+      s0 = STEP(s0, (long) a[i]);                                       \
+      s1 = STEP(s1, (long) a[i + 1]);                                   \
+      s2 = STEP(s2, (long) a[i + 2]);                                   \
+      s3 = STEP(s3, (long) a[i + 3]);                                   \
+    }                                                                   \
+    for(; i < n; i++)                                                   \
+      s0 = STEP(s0, (long) a[i]);                                       \
+    return COMBINE(COMBINE(s0, s1), COMBINE(s2, s3));                   \
+  }                                                                     \
+                                                                        \
+  reduction_op_t reduction_##NAME =                                     \
+    {#NAME, IDENTITY, NAME##_chunk, NAME##_combine};
+
+#define ADD(x, y) ((x) + (y))
+#define MIN(x, y) (((x) < (y)) ? (x) : (y))
+#define MAX(x, y) (((x) > (y)) ? (x) : (y))
+#define ADD_SQUARE(acc, x) ((acc) + (x) * (x))
+
+DEFINE_REDUCTION(min, LONG_MAX, MIN, MIN)
+DEFINE_REDUCTION(max, LONG_MIN, MAX, MAX)
+DEFINE_REDUCTION(sumsq, 0, ADD_SQUARE, ADD)
+
+/// The sum uses the SIMD kernel selected at startup.
+static long sum_combine(long x, long y)
+{
+  return x + y;
+}
+
+reduction_op_t reduction_sum =
+  {"sum", 0, vector_reduction_sum64, sum_combine};
+
+reduction_op_t *reduction_ops[] =
+  {&reduction_sum, &reduction_min, &reduction_max, &reduction_sumsq, NULL};
+
+/// Partial result of a worker, alone on its cache line so that the
+/// workers do not invalidate each other's line when they update it.
+typedef struct
+{
+  long value;
+  char padding[64 - sizeof(long)];
+} __attribute__((aligned(64))) partial_t;
+
+/// A reduction in progress, shared by the workers.
+typedef struct
+{
+  reduction_op_t *op;
+  int *a;
+  long n;
+  long next_chunk;          ///< Next chunk to reduce
+  partial_t *partials;      ///< One per worker
+} reduction_t;
+
+/// Reduce chunks until none is left.
+static void reduction_worker(void *arg, int id)
+{
+  reduction_t *r = arg;
+  long partial = r->op->identity;
+  long first;
+
+  while ((first = __atomic_fetch_add(&r->next_chunk, REDUCTION_CHUNK,
+                                     __ATOMIC_RELAXED)) < r->n)
+  {
+    long size = (r->n - first < REDUCTION_CHUNK) ? r->n - first : REDUCTION_CHUNK;
+    partial = r->op->combine(partial, r->op->chunk(r->a + first, size));
+  }
+  r->partials[id].value = partial;
+}
+
+long parallel_reduction(worker_pool_t *pool, reduction_op_t *op,
+                        int *a, long n)
+{
+  reduction_t r = {op, a, n, 0, NULL};
+  long result = op->identity;
+
+  r.partials = aligned_alloc(64, pool->n_workers * sizeof(partial_t));
+  worker_pool_run(pool, reduction_worker, &r);
+  for(int id = 0; id < pool->n_workers; id++)
+    result = op->combine(result, r.partials[id].value);
+  free(r.partials);
+  return result;
+}
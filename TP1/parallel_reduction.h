@@ -0,0 +1,40 @@
+#ifndef PARALLEL_REDUCTION_H
+#define PARALLEL_REDUCTION_H
+
+#include "worker_pool.h"
+
+/// An associative reduction operator.
+typedef struct
+{
+  char *name;
+  /// Neutral element of combine.
+  long identity;
+  /// Reduce the n elements of a (a chunk of the vector).
+  long (*chunk)(int *a, long n);
+  /// Combine two partial results.
+  long (*combine)(long x, long y);
+} reduction_op_t;
+
+/// Sum (on 64 bits), min, max and sum of squares.
+extern reduction_op_t reduction_sum;
+extern reduction_op_t reduction_min;
+extern reduction_op_t reduction_max;
+extern reduction_op_t reduction_sumsq;
+
+/// The operators above, terminated by NULL.
+extern reduction_op_t *reduction_ops[];
+
+/// Number of elements of a chunk (256 KB), small enough to stay in
+/// the L2 cache while it is reduced.
+#define REDUCTION_CHUNK (64 * 1024)
+
+/// Reduce vector a with op on the workers of pool. The workers take
+/// chunks of REDUCTION_CHUNK elements in turn, so a slow worker does
+/// not delay the others, and fold them in their own partial result.
+/// The partial results are then combined by the caller.
+/// @param a A vector of integers represented as a simple array
+/// @param n Size of the vector
+/// @return The reduction of a[0], ..., a[n-1], op->identity if n is 0.
+long parallel_reduction(worker_pool_t *pool, reduction_op_t *op,
+                        int *a, long n);
+#endif
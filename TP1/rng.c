@@ -0,0 +1,184 @@
+#include <string.h>
+
+#include "isa.h"
+#include "rng.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define X86 1
+#endif
+
+/// lowbias32 integer hash.
+static inline uint32_t hash32(uint32_t x)
+{
+  x ^= x >> 16;
+  x *= 0x7feb352dU;
+  x ^= x >> 15;
+  x *= 0x846ca68bU;
+  x ^= x >> 16;
+  return x;
+}
+
+/// @return The key of the elements hi << 32, ..., (hi << 32) + 2^32 - 1
+/// of the stream of seed. Element i is hash32((uint32_t) i ^ key).
+static uint32_t rng_key(uint64_t seed, uint32_t hi)
+{
+  return hash32(hash32((uint32_t) seed ^ hash32(seed >> 32)) + hi);
+}
+
+/// @return x reduced to [0, range), range being at most RNG_RANGE_MAX.
+static inline uint32_t rng_reduce(uint32_t x, uint32_t range)
+{
+  return ((x >> 16) * range) >> 16;
+}
+
+uint32_t rng_at(uint64_t seed, uint64_t i)
+{
+  return hash32((uint32_t) i ^ rng_key(seed, i >> 32));
+}
+
+/// Define the fill kernel of an instruction set for elements of type
+/// T. It hashes WIDTH / 4 consecutive counters at once, with the
+/// vector extensions of the compiler lowered to the instructions
+/// enabled by TARGET.
+/// @param T Element type (int or float).
+/// @param NAME Prefix of the kernel.
+/// @param ISA Name of the instruction set.
+/// @param TARGET Attribute enabling the instruction set.
+/// @param WIDTH Width of the vectors in bytes.
+#define DEFINE_RNG_FILL(T, NAME, ISA, TARGET, WIDTH)                        \
+  TARGET static void NAME##_##ISA(T *v, long n, uint32_t range,            \
+                                  uint32_t key, uint32_t lo)                \
+  {                                                                         \
+    typedef uint32_t uvec __attribute__((vector_size(WIDTH)));              \
+    typedef int32_t ivec __attribute__((vector_size(WIDTH)));               \
+    typedef T tvec __attribute__((vector_size(WIDTH)));                     \
+    const long w = WIDTH / sizeof(uint32_t);                                \
+    uvec counter;                                                           \
+    long i = 0;                                                             \
+                                                                            \
+    for(long k = 0; k < w; k++)                                             \
+      counter[k] = lo + k;                                                  \
+    for(; i + w <= n; i += w, counter += (uint32_t) w)                      \
+    {                                                                       \
+      uvec x = counter ^ key;                                               \
+      x ^= x >> 16;                                                         \
+      x *= 0x7feb352dU;                                                     \
+      x ^= x >> 15;                                                         \
+      x *= 0x846ca68bU;                                                     \
+      x ^= x >> 16;                                                         \
+      x = ((x >> 16) * range) >> 16;                                        \
+      tvec t = __builtin_convertvector((ivec) x, tvec);                     \
+      memcpy(v + i, &t, sizeof(t));                                         \
+    }                                                                       \
+    for(; i < n; i++)                                                       \
+      v[i] = rng_reduce(hash32((lo + (uint32_t) i) ^ key), range);          \
+  }
+
+#ifdef X86
+#define SSE2 __attribute__((target("sse2")))
+#define AVX2 __attribute__((target("avx2")))
+#define AVX512 __attribute__((target("avx512f")))
+DEFINE_RNG_FILL(int, fill, sse2, SSE2, 16)
+DEFINE_RNG_FILL(float, ffill, sse2, SSE2, 16)
+DEFINE_RNG_FILL(int, fill, avx2, AVX2, 32)
+DEFINE_RNG_FILL(float, ffill, avx2, AVX2, 32)
+DEFINE_RNG_FILL(int, fill, avx512, AVX512, 64)
+DEFINE_RNG_FILL(float, ffill, avx512, AVX512, 64)
+#else
+DEFINE_RNG_FILL(int, fill, scalar, , 16)
+DEFINE_RNG_FILL(float, ffill, scalar, , 16)
+#endif
+
+/// Fill kernels written for one instruction set.
+typedef struct
+{
+  char *name;
+  void (*fill)(int *v, long n, uint32_t range, uint32_t key, uint32_t lo);
+  void (*ffill)(float *v, long n, uint32_t range, uint32_t key, uint32_t lo);
+} rng_kernel_t;
+
+static rng_kernel_t rng_kernels[] =
+{
+#ifdef X86
+  {"sse2",   fill_sse2,   ffill_sse2},
+  {"avx2",   fill_avx2,   ffill_avx2},
+  {"avx512", fill_avx512, ffill_avx512},
+#else
+  {"scalar", fill_scalar, ffill_scalar},
+#endif
+  {NULL}
+};
+
+/// The kernel selected at startup.
+static rng_kernel_t *best = rng_kernels;
+
+/// Select the fastest supported kernel before main starts.
+__attribute__((constructor))
+static void rng_init()
+{
+  for(rng_kernel_t *k = rng_kernels; k->name; k++)
+    if (isa_supported(k->name))
+      best = k;
+}
+
+/// @return The number of elements from first to the end of its block
+/// of 2^32 elements sharing the same key, at most n.
+static long rng_block(uint64_t first, long n)
+{
+  uint64_t room = (1ULL << 32) - (uint32_t) first;
+
+  return ((uint64_t) n < room) ? n : (long) room;
+}
+
+void rng_fill(int *v, long n, uint32_t range, uint64_t seed, uint64_t first)
+{
+  while (n > 0)
+  {
+    long len = rng_block(first, n);
+    best->fill(v, len, range, rng_key(seed, first >> 32), (uint32_t) first);
+    v += len;
+    n -= len;
+    first += len;
+  }
+}
+
+void rng_ffill(float *v, long n, uint32_t range, uint64_t seed,
+               uint64_t first)
+{
+  while (n > 0)
+  {
+    long len = rng_block(first, n);
+    best->ffill(v, len, range, rng_key(seed, first >> 32), (uint32_t) first);
+    v += len;
+    n -= len;
+    first += len;
+  }
+}
+
+/// A parallel fill, shared by the workers.
+typedef struct
+{
+  worker_pool_t *pool;
+  int *v;
+  long n;
+  uint32_t range;
+  uint64_t seed;
+} rng_fill_t;
+
+/// Fill the part of the vector of worker id.
+static void rng_fill_worker(void *arg, int id)
+{
+  rng_fill_t *f = arg;
+  long first, last;
+
+  worker_pool_range(f->pool, id, f->n, &first, &last);
+  rng_fill(f->v + first, last - first, f->range, f->seed, first);
+}
+
+void parallel_rng_fill(worker_pool_t *pool, int *v, long n, uint32_t range,
+                       uint64_t seed)
+{
+  rng_fill_t f = {pool, v, n, range, seed};
+
+  worker_pool_run(pool, rng_fill_worker, &f);
+}
@@ -0,0 +1,34 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <stdint.h>
+
+#include "worker_pool.h"
+
+/// Counter-based random generator: element i of the stream of seed is
+/// a hash of (seed, i), computed without any state. Any part of a
+/// stream can thus be generated independently, by any thread, with
+/// SIMD instructions, and a fill gives the same values whatever the
+/// number of threads. The hash is lowbias32 (good avalanche, not
+/// cryptographic).
+
+/// Largest range accepted by the fills.
+#define RNG_RANGE_MAX 65536
+
+/// @return Element i of the stream of seed, uniform over 32 bits.
+uint32_t rng_at(uint64_t seed, uint64_t i);
+
+/// Store elements first, ..., first + n - 1 of the stream of seed in
+/// v, reduced to [0, range).
+/// @param range At most RNG_RANGE_MAX.
+void rng_fill(int *v, long n, uint32_t range, uint64_t seed, uint64_t first);
+
+/// Same as rng_fill for a vector of floats (integral values).
+void rng_ffill(float *v, long n, uint32_t range, uint64_t seed,
+               uint64_t first);
+
+/// Same as rng_fill (with first 0), each worker of pool filling a
+/// contiguous part of v.
+void parallel_rng_fill(worker_pool_t *pool, int *v, long n, uint32_t range,
+                       uint64_t seed);
+#endif
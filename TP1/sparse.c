@@ -0,0 +1,116 @@
+#include <stdlib.h>
+
+#include "sparse.h"
+
+csr_t *csr_from_matrix(matrix_t *m)
+{
+  csr_t *a = malloc(sizeof(csr_t));
+  long nnz = 0;
+
+  if (a == NULL)
+    return NULL;
+  for(long i = 0; i < m->rows; i++)
+    for(long j = 0; j < m->cols; j++)
+      nnz += MATRIX_AT(m, i, j) != 0;
+
+  a->rows = m->rows;
+  a->cols = m->cols;
+  a->nnz = nnz;
+  a->row_start = malloc((m->rows + 1) * sizeof(long));
+  a->col = malloc((nnz > 0 ? nnz : 1) * sizeof(int));
+  a->val = malloc((nnz > 0 ? nnz : 1) * sizeof(int));
+  if (a->row_start == NULL || a->col == NULL || a->val == NULL)
+  {
+    csr_free(a);
+    return NULL;
+  }
+
+  nnz = 0;
+  for(long i = 0; i < m->rows; i++)
+  {
+    a->row_start[i] = nnz;
+    for(long j = 0; j < m->cols; j++)
+      if (MATRIX_AT(m, i, j) != 0)
+      {
+        a->col[nnz] = j;
+        a->val[nnz] = MATRIX_AT(m, i, j);
+        nnz++;
+      }
+  }
+  a->row_start[m->rows] = nnz;
+  return a;
+}
+
+void csr_free(csr_t *a)
+{
+  free(a->row_start);
+  free(a->col);
+  free(a->val);
+  free(a);
+}
+
+void csr_matrix_vector_rows(int *y, csr_t *a, int *v, long first, long last)
+{
+  for(long i = first; i < last; i++)
+  {
+    int sum = 0;
+    for(long k = a->row_start[i]; k < a->row_start[i + 1]; k++)
+      sum += a->val[k] * v[a->col[k]];
+    y[i] = sum;
+  }
+}
+
+void csr_matrix_vector(int *y, csr_t *a, int *v)
+{
+  csr_matrix_vector_rows(y, a, v, 0, a->rows);
+}
+
+/// @return The first row of part k of n_parts parts holding about the
+/// same number of nonzero elements: the first row starting at or
+/// after element k * nnz / n_parts. The last part ends at a->rows,
+/// trailing empty rows included.
+static long csr_part_start(csr_t *a, int k, int n_parts)
+{
+  long target = a->nnz * k / n_parts;
+  long low = 0, high = a->rows;
+
+  if (k == n_parts)
+    return a->rows;
+  // Binary search of the first i such that row_start[i] >= target
+  while (low < high)
+  {
+    long middle = (low + high) / 2;
+    if (a->row_start[middle] < target)
+      low = middle + 1;
+    else
+      high = middle;
+  }
+  return low;
+}
+
+/// A parallel product, shared by the workers.
+typedef struct
+{
+  worker_pool_t *pool;
+  int *y;
+  csr_t *a;
+  int *v;
+} csr_product_t;
+
+/// Multiply the rows of worker id.
+static void csr_worker(void *arg, int id)
+{
+  csr_product_t *p = arg;
+  int n = p->pool->n_workers;
+
+  csr_matrix_vector_rows(p->y, p->a, p->v, csr_part_start(p->a, id, n),
+                         csr_part_start(p->a, id + 1, n));
+}
+
+void parallel_csr_matrix_vector(worker_pool_t *pool, int *y, csr_t *a,
+                                int *v)
+{
+  csr_product_t p = {pool, y, a, v};
+
+  worker_pool_run(pool, csr_worker, &p);
+}
@@ -0,0 +1,44 @@
+#ifndef SPARSE_H
+#define SPARSE_H
+
+#include "matrix.h"
+#include "worker_pool.h"
+
+/// Sparse matrix of integers in compressed sparse row (CSR) format:
+/// the nonzero elements of row i are val[row_start[i]] to
+/// val[row_start[i + 1] - 1], in column order, and col holds their
+/// columns.
+typedef struct
+{
+  long rows;
+  long cols;
+  long nnz;         ///< Number of nonzero elements
+  long *row_start;  ///< rows + 1 offsets into col and val
+  int *col;         ///< nnz column indices
+  int *val;         ///< nnz values
+} csr_t;
+
+/// Convert a dense matrix to CSR, dropping its zeros.
+/// @return The new sparse matrix, NULL if memory is exhausted.
+csr_t *csr_from_matrix(matrix_t *m);
+
+/// Free a matrix created by csr_from_matrix.
+void csr_free(csr_t *a);
+
+/// Store in y[first..last-1] the products of rows first to last - 1 of
+/// a by v.
+void csr_matrix_vector_rows(int *y, csr_t *a, int *v, long first,
+                            long last);
+
+/// Multiply sparse matrix a with vector v and store the result in y.
+/// @param y The result vector, of a->rows elements.
+/// @param v The input vector, of a->cols elements.
+void csr_matrix_vector(int *y, csr_t *a, int *v);
+
+/// Same as csr_matrix_vector on the workers of pool. The rows are
+/// split into contiguous parts of about nnz / n_workers nonzero
+/// elements each (not rows), so that a few dense rows do not leave
+/// the other workers idle.
+void parallel_csr_matrix_vector(worker_pool_t *pool, int *y, csr_t *a,
+                                int *v);
+#endif
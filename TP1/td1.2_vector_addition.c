@@ -1,15 +1,6 @@
 #include <stdio.h>
 
-/// Add the two vectors a and b element-wise and store the result in vector c.
-/// @param c The result of the vector addition.
-/// @param a A vector of integers represented as a simple array
-/// @param b A vector of integers represented as a simple array
-/// @param n Size of the vectors
-void vector_add(int *c, int *a, int *b, int n) 
-{
-  for(int i = 0; i < n; i++)
-    c[i] = a[i] + b[i];
-}
+#include "vector_add.h"
 
 /// Print the value of each element of a vector.
 /// @param v The vector to print.
@@ -41,8 +32,9 @@ int main()
   int dest[vsize];
 
 
-  // perform the vector addition
-  vector_add(dest, src1, src2, vsize);
+  // perform the vector addition with the fastest kernel supported by
+  // the processor
+  vector_add_simd(dest, src1, src2, vsize);
 
   // print the vectors
   printf("src1: "); vector_print(src1, vsize);
@@ -1,114 +1,93 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 
-/// define the size of the matrices
-#define SIZE 500
-
-/// Matrix representation as two-dimensional array
-typedef int (*matrix_t)[SIZE];
+#include "matrix.h"
+#include "rng.h"
 
-/// Vector representation as a simple array
-typedef int vector_t[SIZE];
+/// default size of the matrices
+#define SIZE 500
 
 /// Multiply matrix m with vector v and store the result in d.
 /// @param d The result matrix.
 /// @param m The input matrix.
 /// @param v The input vector.
-void matrix_vector_multiply(matrix_t d, matrix_t m, vector_t v)
-{
-  for(int i = 0; i < SIZE; i++ )
-  {
-    for(int j = 0; j < SIZE; j++ )
-    {
-      d[j][i] = m[j][i] * v[i];
-    }
-  }
-}
-
-/// Initialize a given matrix with random values (module 5).
-/// @param a The matrix to initialize.
-void matrix_init_rand(matrix_t a)
+void matrix_vector_multiply(matrix_t *d, matrix_t *m, int *v)
 {
-  for(int i = 0; i < SIZE; i++ )
+  for(long i = 0; i < m->cols; i++ )
   {
-    for(int j = 0; j < SIZE; j++ )
+    for(long j = 0; j < m->rows; j++ )
     {
-      a[i][j] = rand() % 5;
+      MATRIX_AT(d, j, i) = MATRIX_AT(m, j, i) * v[i];
     }
   }
 }
 
-/// Print the elements of a matrix.
-/// @param m The matrix to print.
-void matrix_print(matrix_t m)
-{
-  for(int i = 0; i < SIZE; i++ )
-  {
-    for(int j = 0; j < SIZE; j++ )
-    {
-      printf("%3d ", m[i][j]);
-    }
-    printf("\n");
-  }
-}
-
-/// Allocate a matrix of SIZE x SIZE elements on the heap.
-/// @return A pointer to a newly allocated block of memory for a matrix.
-matrix_t matrix_alloc()
-{
-  void *p = malloc(sizeof(int) * SIZE * SIZE);
-  return p;
-}
-
 /// Initialize a given vector with random values (module 5).
 /// @param v The vector to initialize.
-void vector_init_rand(vector_t v)
+/// @param n Size of the vector.
+void vector_init_rand(int *v, long n)
 {
-  for(int i = 0; i < SIZE; i++ )
-  {
-    v[i] = rand() % 5;
-  }
+  rng_fill(v, n, 5, MATRIX_SEED + 1, 0);
 }
 
-/// Print the value of each element of a vector.
-/// @param v The vector to print.
-void vector_print(int *v)
+/// Create an input matrix and vector with random data, multiply them, and 
+/// display the result. The matrices are rows x cols, given on the
+/// command line (SIZE x SIZE by default). With -b, they are written
+/// to the standard output in binary instead (see matrix_dump).
+/// @return 0 on success, 1 on error.
+int main(int argc, char *argv[])
 {
-  printf("(");
-  for(int i = 0; i < SIZE; i++) 
+  int binary = (argc > 1) && (strcmp(argv[1], "-b") == 0);
+  long rows = (argc > 1 + binary) ? atol(argv[1 + binary]) : SIZE;
+  long cols = (argc > 2 + binary) ? atol(argv[2 + binary]) : rows;
+
+  if ((argc > 3 + binary) || (rows < 1) || (cols < 1))
   {
-    if (i == SIZE - 1)
-      printf("%d)\n", v[i]);
-    else
-      printf("%d ", v[i]);
+    printf("Usage : %s [-b] [rows [cols]]\n", argv[0]);
+    return 1;
   }
-}
 
-/// Create an input matrix and vector with random data, multiply them, and 
-/// display the result.
-/// @return Always returns 0.
-int main()
-{
   // allocate two matrices and a vector
-  matrix_t dest = matrix_alloc();
-  matrix_t msrc = matrix_alloc();
-  vector_t vsrc = {0,};
+  matrix_t *dest = matrix_alloc(rows, cols, 0);
+  matrix_t *msrc = matrix_alloc(rows, cols, 0);
+  int *vsrc = vector_alloc(cols);
+  if (dest == NULL || msrc == NULL || vsrc == NULL)
+  {
+    printf("cannot allocate %ld x %ld matrices\n", rows, cols);
+    return 1;
+  }
 
   // initialize two of them
   matrix_init_rand(msrc);
-  vector_init_rand(vsrc);
+  vector_init_rand(vsrc, cols);
 
   // perform the matrix vector product
   matrix_vector_multiply(dest, msrc, vsrc);
 
   // print the matrices and the vector
-  printf("vsrc:\n"); vector_print(vsrc);
-  printf("msrc:\n"); matrix_print(msrc);
-  printf("dest:\n"); matrix_print(dest);
+  if (binary)
+  {
+    if (vector_dump(vsrc, cols, STDOUT_FILENO) < 0 ||
+        matrix_dump(msrc, STDOUT_FILENO) < 0 ||
+        matrix_dump(dest, STDOUT_FILENO) < 0)
+    {
+      perror("write");
+      return 1;
+    }
+  }
+  else
+  {
+    printf("vsrc:\n"); vector_print(vsrc, cols);
+    printf("msrc:\n"); matrix_print(msrc);
+    printf("dest:\n"); matrix_print(dest);
+  }
 
   // free dynamically allocated memory
-  free(dest);
-  free(msrc);
+  matrix_free(dest);
+  matrix_free(msrc);
+  free(vsrc);
   
   return 0;
 }
@@ -0,0 +1,183 @@
+#include <stdint.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define X86 1
+#endif
+
+#include "isa.h"
+#include "vector_add.h"
+
+/// Scalar kernels: the original loop, one element at a time.
+SCALAR static void add_scalar(int *c, int *a, int *b, long n, int stream)
+{
+  for(long i = 0; i < n; i++)
+    c[i] = a[i] + b[i];
+}
+
+SCALAR static void add3_scalar(int *c, int *a, int *b, int *d, long n,
+                               int stream)
+{
+  for(long i = 0; i < n; i++)
+    c[i] = a[i] + b[i] + d[i];
+}
+
+#ifdef X86
+/// Define the add and add3 kernels of an instruction set.
+/// @param ISA Name of the instruction set.
+/// @param TARGET Target attribute enabling the instruction set.
+/// @param VEC Vector type.
+/// @param LOAD, ADD, STORE, STREAM Unaligned load, 32-bit addition,
+/// aligned store and non-temporal store of VEC.
+#define DEFINE_ADD_KERNELS(ISA, TARGET, VEC, LOAD, ADD, STORE, STREAM)     \
+  __attribute__((target(TARGET)))                                          \
+  static void add_##ISA(int *c, int *a, int *b, long n, int stream)       \
+  {                                                                         \
+    long w = sizeof(VEC) / sizeof(int);                                     \
+    long i = 0;                                                             \
+                                                                            \
+    for(; i < n && (uintptr_t) (c + i) % sizeof(VEC) != 0; i++)             \
+      c[i] = a[i] + b[i];                                                   \
+    if (stream)                                                             \
+    {                                                                       \
+      for(; i + w <= n; i += w)                                             \
+        STREAM((VEC *) (c + i), ADD(LOAD((VEC *) (a + i)),                  \
+                                    LOAD((VEC *) (b + i))));                \
+      _mm_sfence();                                                         \
+    }                                                                       \
+    else                                                                    \
+      for(; i + w <= n; i += w)                                             \
+        STORE((VEC *) (c + i), ADD(LOAD((VEC *) (a + i)),                   \
+                                   LOAD((VEC *) (b + i))));                 \
+    for(; i < n; i++)                                                       \
+      c[i] = a[i] + b[i];                                                   \
+  }                                                                         \
+                                                                            \
+  __attribute__((target(TARGET)))                                          \
+  static void add3_##ISA(int *c, int *a, int *b, int *d, long n,           \
+                         int stream)                                        \
+  {                                                                         \
+    long w = sizeof(VEC) / sizeof(int);                                     \
+    long i = 0;                                                             \
+                                                                            \
+    for(; i < n && (uintptr_t) (c + i) % sizeof(VEC) != 0; i++)             \
+      c[i] = a[i] + b[i] + d[i];                                            \
+    if (stream)                                                             \
+    {                                                                       \
+      for(; i + w <= n; i += w)                                             \
+        STREAM((VEC *) (c + i), ADD(ADD(LOAD((VEC *) (a + i)),              \
+                                        LOAD((VEC *) (b + i))),             \
+                                    LOAD((VEC *) (d + i))));                \
+      _mm_sfence();                                                         \
+    }                                                                       \
+    else                                                                    \
+      for(; i + w <= n; i += w)                                             \
+        STORE((VEC *) (c + i), ADD(ADD(LOAD((VEC *) (a + i)),               \
+                                       LOAD((VEC *) (b + i))),              \
+                                   LOAD((VEC *) (d + i))));                 \
+    for(; i < n; i++)                                                       \
+      c[i] = a[i] + b[i] + d[i];                                            \
+  }
+
+DEFINE_ADD_KERNELS(sse2, "sse2", __m128i, _mm_loadu_si128,
+                   _mm_add_epi32, _mm_store_si128, _mm_stream_si128)
+DEFINE_ADD_KERNELS(avx2, "avx2", __m256i, _mm256_loadu_si256,
+                   _mm256_add_epi32, _mm256_store_si256, _mm256_stream_si256)
+DEFINE_ADD_KERNELS(avx512, "avx512f", __m512i, _mm512_loadu_si512,
+                   _mm512_add_epi32, _mm512_store_si512, _mm512_stream_si512)
+#endif
+
+vector_add_kernel_t vector_add_kernels[] =
+{
+  {"scalar", add_scalar, add3_scalar},
+#ifdef X86
+  {"sse2",   add_sse2,   add3_sse2},
+  {"avx2",   add_avx2,   add3_avx2},
+  {"avx512", add_avx512, add3_avx512},
+#endif
+  {NULL}
+};
+
+/// The kernel selected at startup.
+static vector_add_kernel_t *best = vector_add_kernels;
+
+/// Last level cache size, read at startup.
+static long stream_threshold = 8L << 20;
+
+/// Select the fastest supported kernel and read the cache size
+/// before main starts.
+__attribute__((constructor))
+static void vector_add_init()
+{
+  for(vector_add_kernel_t *k = vector_add_kernels; k->name; k++)
+    if (isa_supported(k->name))
+      best = k;
+#ifdef _SC_LEVEL3_CACHE_SIZE
+  if (sysconf(_SC_LEVEL3_CACHE_SIZE) > 0)
+    stream_threshold = sysconf(_SC_LEVEL3_CACHE_SIZE);
+  else if (sysconf(_SC_LEVEL2_CACHE_SIZE) > 0)
+    stream_threshold = sysconf(_SC_LEVEL2_CACHE_SIZE);
+#endif
+}
+
+vector_add_kernel_t *vector_add_best()
+{
+  return best;
+}
+
+long vector_add_stream_threshold()
+{
+  return stream_threshold;
+}
+
+void vector_add_simd(int *c, int *a, int *b, long n)
+{
+  best->add(c, a, b, n, n * (long) sizeof(int) > stream_threshold);
+}
+
+void vector_add3_simd(int *c, int *a, int *b, int *d, long n)
+{
+  best->add3(c, a, b, d, n, n * (long) sizeof(int) > stream_threshold);
+}
+
+/// A parallel addition, shared by the workers.
+typedef struct
+{
+  worker_pool_t *pool;
+  int *c, *a, *b, *d;   ///< d is NULL for c = a + b
+  long n;
+  int stream;           ///< Decided on the whole result, not on a part
+} vector_add_t;
+
+/// Add the part of the vectors of worker id.
+static void vector_add_worker(void *arg, int id)
+{
+  vector_add_t *v = arg;
+  long first, last;
+
+  worker_pool_range(v->pool, id, v->n, &first, &last);
+  if (v->d == NULL)
+    best->add(v->c + first, v->a + first, v->b + first, last - first,
+              v->stream);
+  else
+    best->add3(v->c + first, v->a + first, v->b + first, v->d + first,
+               last - first, v->stream);
+}
+
+void parallel_vector_add(worker_pool_t *pool, int *c, int *a, int *b, long n)
+{
+  vector_add_t v = {pool, c, a, b, NULL, n,
+                    n * (long) sizeof(int) > stream_threshold};
+
+  worker_pool_run(pool, vector_add_worker, &v);
+}
+
+void parallel_vector_add3(worker_pool_t *pool,
+                          int *c, int *a, int *b, int *d, long n)
+{
+  vector_add_t v = {pool, c, a, b, d, n,
+                    n * (long) sizeof(int) > stream_threshold};
+
+  worker_pool_run(pool, vector_add_worker, &v);
+}
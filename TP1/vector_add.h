@@ -0,0 +1,51 @@
+#ifndef VECTOR_ADD_H
+#define VECTOR_ADD_H
+
+#include "worker_pool.h"
+
+/// Element-wise addition kernels written for one instruction set.
+/// Loads may be unaligned: a scalar head aligns the stores on the
+/// vector width and a scalar tail ends the vector. When stream is set,
+/// the result is written with non-temporal stores, which bypass the
+/// caches instead of evicting the inputs.
+typedef struct
+{
+  /// Name of the instruction set ("scalar", "sse2", "avx2", "avx512").
+  char *name;
+  /// c = a + b
+  void (*add)(int *c, int *a, int *b, long n, int stream);
+  /// c = a + b + d, in a single pass
+  void (*add3)(int *c, int *a, int *b, int *d, long n, int stream);
+} vector_add_kernel_t;
+
+/// The kernels compiled in, from the most portable to the fastest.
+/// The table is terminated by an entry with a NULL name.
+extern vector_add_kernel_t vector_add_kernels[];
+
+/// @return The fastest kernel supported by the processor.
+vector_add_kernel_t *vector_add_best();
+
+/// @return The size of the last level cache in bytes. Results larger
+/// than this are written with non-temporal stores.
+long vector_add_stream_threshold();
+
+/// Add the two vectors a and b element-wise and store the result in
+/// vector c, with the fastest kernel.
+/// @param c The result of the vector addition.
+/// @param a A vector of integers represented as a simple array
+/// @param b A vector of integers represented as a simple array
+/// @param n Size of the vectors
+void vector_add_simd(int *c, int *a, int *b, long n);
+
+/// Store a + b + d in c, reading each input once.
+void vector_add3_simd(int *c, int *a, int *b, int *d, long n);
+
+/// Same as vector_add_simd, each worker of pool adding a contiguous
+/// part of the vectors.
+void parallel_vector_add(worker_pool_t *pool, int *c, int *a, int *b, long n);
+
+/// Same as vector_add3_simd, each worker of pool adding a contiguous
+/// part of the vectors.
+void parallel_vector_add3(worker_pool_t *pool,
+                          int *c, int *a, int *b, int *d, long n);
+#endif
@@ -0,0 +1,226 @@
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define X86 1
+#endif
+
+#include "isa.h"
+#include "vector_reduction.h"
+
+/// Scalar kernel: the original loop, one element at a time.
+SCALAR static int sum_scalar(int *a, long n)
+{
+  unsigned int sum = 0;
+  for(long i = 0; i < n; i++)
+    sum += a[i];
+
+  return sum;
+}
+
+SCALAR static long sum64_scalar(int *a, long n)
+{
+  long sum = 0;
+  for(long i = 0; i < n; i++)
+    sum += a[i];
+
+  return sum;
+}
+
+#ifdef X86
+/// SSE2 kernel: 4 accumulators of 4 lanes, 16 elements per iteration.
+__attribute__((target("sse2")))
+static int sum_sse2(int *a, long n)
+{
+  __m128i s0 = _mm_setzero_si128(), s1 = s0, s2 = s0, s3 = s0;
+  int lanes[4];
+  long i = 0;
+
+  for(; i + 16 <= n; i += 16)
+  {
+    s0 = _mm_add_epi32(s0, _mm_loadu_si128((__m128i *) (a + i)));
+    s1 = _mm_add_epi32(s1, _mm_loadu_si128((__m128i *) (a + i + 4)));
+    s2 = _mm_add_epi32(s2, _mm_loadu_si128((__m128i *) (a + i + 8)));
+    s3 = _mm_add_epi32(s3, _mm_loadu_si128((__m128i *) (a + i + 12)));
+  }
+  s0 = _mm_add_epi32(_mm_add_epi32(s0, s1), _mm_add_epi32(s2, s3));
+  for(; i + 4 <= n; i += 4)
+    s0 = _mm_add_epi32(s0, _mm_loadu_si128((__m128i *) (a + i)));
+
+  _mm_storeu_si128((__m128i *) lanes, s0);
+  unsigned int sum = (unsigned int) lanes[0] + lanes[1] + lanes[2] + lanes[3];
+  for(; i < n; i++)
+    sum += a[i];
+  return sum;
+}
+
+/// SSE2 has no sign extension from 32 to 64 bits: interleave each
+/// element with its sign mask instead.
+__attribute__((target("sse2")))
+static long sum64_sse2(int *a, long n)
+{
+  __m128i zero = _mm_setzero_si128(), s0 = zero, s1 = zero;
+  long lanes[2];
+  long i = 0;
+
+  for(; i + 4 <= n; i += 4)
+  {
+    __m128i x = _mm_loadu_si128((__m128i *) (a + i));
+    __m128i sign = _mm_cmpgt_epi32(zero, x);
+    s0 = _mm_add_epi64(s0, _mm_unpacklo_epi32(x, sign));
+    s1 = _mm_add_epi64(s1, _mm_unpackhi_epi32(x, sign));
+  }
+  _mm_storeu_si128((__m128i *) lanes, _mm_add_epi64(s0, s1));
+  long sum = lanes[0] + lanes[1];
+  for(; i < n; i++)
+    sum += a[i];
+  return sum;
+}
+
+/// AVX2 kernel: 4 accumulators of 8 lanes, 32 elements per iteration.
+__attribute__((target("avx2")))
+static int sum_avx2(int *a, long n)
+{
+  __m256i s0 = _mm256_setzero_si256(), s1 = s0, s2 = s0, s3 = s0;
+  long i = 0;
+
+  for(; i + 32 <= n; i += 32)
+  {
+    s0 = _mm256_add_epi32(s0, _mm256_loadu_si256((__m256i *) (a + i)));
+    s1 = _mm256_add_epi32(s1, _mm256_loadu_si256((__m256i *) (a + i + 8)));
+    s2 = _mm256_add_epi32(s2, _mm256_loadu_si256((__m256i *) (a + i + 16)));
+    s3 = _mm256_add_epi32(s3, _mm256_loadu_si256((__m256i *) (a + i + 24)));
+  }
+  s0 = _mm256_add_epi32(_mm256_add_epi32(s0, s1), _mm256_add_epi32(s2, s3));
+  for(; i + 8 <= n; i += 8)
+    s0 = _mm256_add_epi32(s0, _mm256_loadu_si256((__m256i *) (a + i)));
+
+  __m128i s = _mm_add_epi32(_mm256_castsi256_si128(s0),
+                            _mm256_extracti128_si256(s0, 1));
+  s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(1, 0, 3, 2)));
+  s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(2, 3, 0, 1)));
+  unsigned int sum = _mm_cvtsi128_si32(s);
+  for(; i < n; i++)
+    sum += a[i];
+  return sum;
+}
+
+__attribute__((target("avx2")))
+static long sum64_avx2(int *a, long n)
+{
+  __m256i s0 = _mm256_setzero_si256(), s1 = s0, s2 = s0, s3 = s0;
+  long lanes[4];
+  long i = 0;
+
+  for(; i + 16 <= n; i += 16)
+  {
+    s0 = _mm256_add_epi64(s0, _mm256_cvtepi32_epi64(
+                            _mm_loadu_si128((__m128i *) (a + i))));
+    s1 = _mm256_add_epi64(s1, _mm256_cvtepi32_epi64(
+                            _mm_loadu_si128((__m128i *) (a + i + 4))));
+    s2 = _mm256_add_epi64(s2, _mm256_cvtepi32_epi64(
+                            _mm_loadu_si128((__m128i *) (a + i + 8))));
+    s3 = _mm256_add_epi64(s3, _mm256_cvtepi32_epi64(
+                            _mm_loadu_si128((__m128i *) (a + i + 12))));
+  }
+  s0 = _mm256_add_epi64(_mm256_add_epi64(s0, s1), _mm256_add_epi64(s2, s3));
+  _mm256_storeu_si256((__m256i *) lanes, s0);
+  long sum = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+  for(; i < n; i++)
+    sum += a[i];
+  return sum;
+}
+
+/// AVX-512 kernel: 4 accumulators of 16 lanes, 64 elements per
+/// iteration. The tail is read with a masked load.
+__attribute__((target("avx512f")))
+static int sum_avx512(int *a, long n)
+{
+  __m512i s0 = _mm512_setzero_si512(), s1 = s0, s2 = s0, s3 = s0;
+  long i = 0;
+
+  for(; i + 64 <= n; i += 64)
+  {
+    s0 = _mm512_add_epi32(s0, _mm512_loadu_si512(a + i));
+    s1 = _mm512_add_epi32(s1, _mm512_loadu_si512(a + i + 16));
+    s2 = _mm512_add_epi32(s2, _mm512_loadu_si512(a + i + 32));
+    s3 = _mm512_add_epi32(s3, _mm512_loadu_si512(a + i + 48));
+  }
+  s0 = _mm512_add_epi32(_mm512_add_epi32(s0, s1), _mm512_add_epi32(s2, s3));
+  for(; i + 16 <= n; i += 16)
+    s0 = _mm512_add_epi32(s0, _mm512_loadu_si512(a + i));
+  if (i < n)
+    s0 = _mm512_add_epi32(s0, _mm512_maskz_loadu_epi32(
+                            (__mmask16) ((1 << (n - i)) - 1), a + i));
+  return _mm512_reduce_add_epi32(s0);
+}
+
+__attribute__((target("avx512f")))
+static long sum64_avx512(int *a, long n)
+{
+  __m512i s0 = _mm512_setzero_si512(), s1 = s0, s2 = s0, s3 = s0;
+  long i = 0;
+
+  for(; i + 32 <= n; i += 32)
+  {
+    s0 = _mm512_add_epi64(s0, _mm512_cvtepi32_epi64(
+                            _mm256_loadu_si256((__m256i *) (a + i))));
+    s1 = _mm512_add_epi64(s1, _mm512_cvtepi32_epi64(
+                            _mm256_loadu_si256((__m256i *) (a + i + 8))));
+    s2 = _mm512_add_epi64(s2, _mm512_cvtepi32_epi64(
+                            _mm256_loadu_si256((__m256i *) (a + i + 16))));
+    s3 = _mm512_add_epi64(s3, _mm512_cvtepi32_epi64(
+                            _mm256_loadu_si256((__m256i *) (a + i + 24))));
+  }
+  s0 = _mm512_add_epi64(_mm512_add_epi64(s0, s1), _mm512_add_epi64(s2, s3));
+  for(; i + 8 <= n; i += 8)
+    s0 = _mm512_add_epi64(s0, _mm512_cvtepi32_epi64(
+                            _mm256_loadu_si256((__m256i *) (a + i))));
+  if (i < n)
+    s0 = _mm512_add_epi64(s0, _mm512_cvtepi32_epi64(
+                            _mm512_castsi512_si256(_mm512_maskz_loadu_epi32(
+                              (__mmask16) ((1 << (n - i)) - 1), a + i))));
+  return _mm512_reduce_add_epi64(s0);
+}
+#endif
+
+vector_reduction_kernel_t vector_reduction_kernels[] =
+{
+  {"scalar", sum_scalar, sum64_scalar},
+#ifdef X86
+  {"sse2",   sum_sse2,   sum64_sse2},
+  {"avx2",   sum_avx2,   sum64_avx2},
+  {"avx512", sum_avx512, sum64_avx512},
+#endif
+  {NULL}
+};
+
+int vector_reduction_supported(vector_reduction_kernel_t *k)
+{
+  return isa_supported(k->name);
+}
+
+/// The kernel selected at startup.
+static vector_reduction_kernel_t *best = vector_reduction_kernels;
+
+/// Select the fastest supported kernel before main starts.
+__attribute__((constructor))
+static void vector_reduction_init()
+{
+  for(vector_reduction_kernel_t *k = vector_reduction_kernels; k->name; k++)
+    if (vector_reduction_supported(k))
+      best = k;
+}
+
+vector_reduction_kernel_t *vector_reduction_best()
+{
+  return best;
+}
+
+int vector_reduction_sum(int *a, long n)
+{
+  return best->sum(a, n);
+}
+
+long vector_reduction_sum64(int *a, long n)
+{
+  return best->sum64(a, n);
+}
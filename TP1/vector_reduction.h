@@ -0,0 +1,41 @@
+#ifndef VECTOR_REDUCTION_H
+#define VECTOR_REDUCTION_H
+
+/// A reduction kernel written for one instruction set. Each kernel
+/// keeps several independent accumulators so that consecutive
+/// additions do not wait for each other.
+typedef struct
+{
+  /// Name of the instruction set ("scalar", "sse2", "avx2", "avx512").
+  char *name;
+  /// Sum of the n elements of a, computed modulo 2^32 like an int sum.
+  int (*sum)(int *a, long n);
+  /// Sum of the n elements of a, accumulated on 64 bits so that it
+  /// cannot overflow for any n below 2^32.
+  long (*sum64)(int *a, long n);
+} vector_reduction_kernel_t;
+
+/// The kernels compiled in, from the most portable to the fastest.
+/// The table is terminated by an entry with a NULL name.
+extern vector_reduction_kernel_t vector_reduction_kernels[];
+
+/// @param k A kernel of vector_reduction_kernels.
+/// @return Whether the processor supports the instruction set of k.
+int vector_reduction_supported(vector_reduction_kernel_t *k);
+
+/// @return The fastest kernel supported by the processor, which is
+/// the one used by vector_reduction_sum and vector_reduction_sum64.
+vector_reduction_kernel_t *vector_reduction_best();
+
+/// @param a A vector of integers represented as a simple array
+/// @param n Size of the vector
+/// @return The sum over all elements in the vector, i.e.,
+/// a[0] + a[1] + ... + a[n-1], modulo 2^32
+int vector_reduction_sum(int *a, long n);
+
+/// @param a A vector of integers represented as a simple array
+/// @param n Size of the vector
+/// @return The sum over all elements in the vector, accumulated on
+/// 64 bits
+long vector_reduction_sum64(int *a, long n);
+#endif
@@ -0,0 +1,113 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "worker_pool.h"
+
+/// Argument of a background thread.
+typedef struct
+{
+  worker_pool_t *pool;
+  int id;
+} worker_t;
+
+/// Main loop of a background thread: wait for a new work, run it,
+/// report its completion.
+void *worker_main(void *arg)
+{
+  worker_t *worker = arg;
+  worker_pool_t *pool = worker->pool;
+  long generation = 0;
+
+  pthread_mutex_lock(&pool->mutex);
+  while (1)
+  {
+    while (!pool->shutdown && pool->generation == generation)
+      pthread_cond_wait(&pool->start, &pool->mutex);
+    if (pool->shutdown)
+      break;
+    generation = pool->generation;
+    pthread_mutex_unlock(&pool->mutex);
+
+    pool->func(pool->arg, worker->id);
+
+    pthread_mutex_lock(&pool->mutex);
+    if (--pool->n_running == 0)
+      pthread_cond_signal(&pool->done);
+  }
+  pthread_mutex_unlock(&pool->mutex);
+  free(worker);
+  return NULL;
+}
+
+worker_pool_t *worker_pool_init(int n_workers)
+{
+  worker_pool_t *pool = malloc(sizeof(worker_pool_t));
+
+  if (n_workers <= 0)
+    n_workers = sysconf(_SC_NPROCESSORS_ONLN);
+  if (n_workers <= 0)
+    n_workers = 1;
+  pool->n_workers = n_workers;
+  pool->threads = malloc(n_workers * sizeof(pthread_t));
+  pthread_mutex_init(&pool->mutex, NULL);
+  pthread_cond_init(&pool->start, NULL);
+  pthread_cond_init(&pool->done, NULL);
+  pool->generation = 0;
+  pool->n_running = 0;
+  pool->shutdown = 0;
+
+  for(int id = 1; id < n_workers; id++)
+  {
+    worker_t *worker = malloc(sizeof(worker_t));
+    worker->pool = pool;
+    worker->id = id;
+    if (pthread_create(&pool->threads[id], NULL, worker_main, worker) != 0)
+    {
+      printf("cannot create worker %d\n", id);
+      exit(1);
+    }
+  }
+  return pool;
+}
+
+void worker_pool_run(worker_pool_t *pool, worker_func_t func, void *arg)
+{
+  pthread_mutex_lock(&pool->mutex);
+  pool->func = func;
+  pool->arg = arg;
+  pool->n_running = pool->n_workers - 1;
+  pool->generation++;
+  pthread_cond_broadcast(&pool->start);
+  pthread_mutex_unlock(&pool->mutex);
+
+  func(arg, 0);
+
+  pthread_mutex_lock(&pool->mutex);
+  while (pool->n_running > 0)
+    pthread_cond_wait(&pool->done, &pool->mutex);
+  pthread_mutex_unlock(&pool->mutex);
+}
+
+void worker_pool_range(worker_pool_t *pool, int id, long n,
+                       long *first, long *last)
+{
+  *first = n * id / pool->n_workers;
+  *last = n * (id + 1) / pool->n_workers;
+}
+
+void worker_pool_shutdown(worker_pool_t *pool)
+{
+  pthread_mutex_lock(&pool->mutex);
+  pool->shutdown = 1;
+  pthread_cond_broadcast(&pool->start);
+  pthread_mutex_unlock(&pool->mutex);
+
+  for(int id = 1; id < pool->n_workers; id++)
+    pthread_join(pool->threads[id], NULL);
+  pthread_mutex_destroy(&pool->mutex);
+  pthread_cond_destroy(&pool->start);
+  pthread_cond_destroy(&pool->done);
+  free(pool->threads);
+  free(pool);
+}
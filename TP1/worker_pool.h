@@ -0,0 +1,46 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <pthread.h>
+
+/// Work run by every worker of a pool.
+/// @param arg The argument given to worker_pool_run.
+/// @param id The worker identifier, from 0 to n_workers - 1.
+typedef void (*worker_func_t)(void *arg, int id);
+
+/// A fixed set of threads created once and reused by each call to
+/// worker_pool_run, so that parallel kernels do not pay for thread
+/// creation. The calling thread takes part in the work as worker 0.
+typedef struct
+{
+  int n_workers;
+  pthread_t *threads;       ///< n_workers - 1 background threads
+  pthread_mutex_t mutex;
+  pthread_cond_t start;     ///< Signaled when a new work is posted
+  pthread_cond_t done;      ///< Signaled when the last worker is done
+  long generation;          ///< Number of works posted so far
+  int n_running;            ///< Background workers still running the work
+  int shutdown;
+  worker_func_t func;
+  void *arg;
+} worker_pool_t;
+
+/// Create a pool of n_workers workers (including the caller).
+/// @param n_workers Number of workers, 0 for one per online processor.
+/// @return The new pool.
+worker_pool_t *worker_pool_init(int n_workers);
+
+/// Run func(arg, id) on every worker of the pool and wait until all of
+/// them have returned.
+void worker_pool_run(worker_pool_t *pool, worker_func_t func, void *arg);
+
+/// Split range [0, n) into pool->n_workers contiguous parts.
+/// @param id A worker identifier.
+/// @param first Set to the first index of the part of worker id.
+/// @param last Set to the index following the part of worker id.
+void worker_pool_range(worker_pool_t *pool, int id, long n,
+                       long *first, long *last);
+
+/// Stop the background threads and free the pool.
+void worker_pool_shutdown(worker_pool_t *pool);
+#endif
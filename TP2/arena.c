@@ -0,0 +1,71 @@
+#include <stdlib.h>
+#include "arena.h"
+
+// A chunk, followed by the objects allocated from it. The header keeps
+// the objects aligned as malloc would.
+typedef struct arena_chunk_t {
+  struct arena_chunk_t * next;
+} __attribute__((aligned(_Alignof(max_align_t)))) arena_chunk_t;
+
+// The chunk a thread is allocating from, and the arena it belongs to.
+// Arenas are told apart by their id rather than their address, which a
+// new arena may reuse after a destroyed one.
+typedef struct {
+  unsigned long id;
+  char * next;
+  char * end;
+} cursor_t;
+
+static __thread cursor_t cursor;
+
+// Ids handed out to arenas, 0 meaning no arena.
+static atomic_ulong next_id = 1;
+
+void arena_init(arena_t * a, size_t size) {
+  size_t align = _Alignof(max_align_t);
+  a->size = (size + align - 1) / align * align;
+  a->id = atomic_fetch_add(&next_id, 1);
+  atomic_init(&a->chunks, NULL);
+}
+
+void arena_destroy(arena_t * a) {
+  arena_chunk_t * c = atomic_load(&a->chunks);
+  while (c != NULL) {
+    arena_chunk_t * next = c->next;
+    free(c);
+    c = next;
+  }
+  atomic_store(&a->chunks, NULL);
+  // stale cursors are told apart by the id
+  a->id = atomic_fetch_add(&next_id, 1);
+}
+
+// Allocate a new chunk to a, and make it the chunk of the thread.
+// Return 0 if out of memory.
+static int arena_grow(arena_t * a) {
+  arena_chunk_t * c = malloc(ARENA_CHUNK);
+  if (c == NULL) return 0;
+
+  c->next = atomic_load_explicit(&a->chunks, memory_order_relaxed);
+  while (!atomic_compare_exchange_weak_explicit(&a->chunks, &c->next, c,
+                                                memory_order_release,
+                                                memory_order_relaxed))
+    ;
+  cursor.id = a->id;
+  cursor.next = (char *)(c + 1);
+  cursor.end = (char *)c + ARENA_CHUNK;
+  return 1;
+}
+
+void * arena_alloc(arena_t * a) {
+  if (cursor.id != a->id || cursor.next + a->size > cursor.end)
+    if (!arena_grow(a)) return NULL;
+  void * p = cursor.next;
+  cursor.next += a->size;
+  return p;
+}
+
+void arena_unalloc(arena_t * a, void * p) {
+  if (cursor.id == a->id && (char *)p + a->size == cursor.next)
+    cursor.next = p;
+}
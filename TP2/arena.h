@@ -0,0 +1,39 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+#include <stdatomic.h>
+
+// Size of the chunks of an arena in bytes.
+#define ARENA_CHUNK (64 * 1024)
+
+struct arena_chunk_t;
+
+// An allocator of objects of a fixed size, shared by threads. Each
+// thread bumps a pointer in a chunk of its own, so allocations take no
+// lock and touch no shared cache line until the chunk is exhausted.
+// Objects cannot be freed one by one (except the last one allocated by
+// a thread): they are all freed with the arena.
+typedef struct {
+  size_t size;                          // of an object, rounded up
+  unsigned long id;                     // unique among all arenas
+  _Atomic(struct arena_chunk_t *) chunks;
+} arena_t;
+
+// Initialize an empty arena of objects of the given size (at most
+// ARENA_CHUNK / 2).
+void arena_init(arena_t * a, size_t size);
+
+// Free all the objects allocated from a.
+void arena_destroy(arena_t * a);
+
+// Return a new object allocated from a, NULL if out of memory. A
+// thread allocating from several arenas in turn starts a new chunk at
+// each switch.
+void * arena_alloc(arena_t * a);
+
+// Give back p if it is the last object allocated by the calling thread
+// from a, so that its next allocation reuses it. Otherwise p is only
+// freed with the arena.
+void arena_unalloc(arena_t * a, void * p);
+#endif
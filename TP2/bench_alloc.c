@@ -0,0 +1,116 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <pthread.h>
+#include "list.h"
+#include "team.h"
+
+// A run of the benchmark, shared by the threads.
+typedef struct {
+  list_t list;
+  unsigned int max;
+} run_t;
+
+// Return the current value of the monotonic clock in seconds.
+double now() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1E9;
+}
+
+// Return the resident set size of the process in bytes, 0 if unknown.
+long rss() {
+  long size, resident = 0;
+  FILE * f = fopen("/proc/self/statm", "r");
+  if (f == NULL) return 0;
+  if (fscanf(f, "%ld %ld", &size, &resident) != 2) resident = 0;
+  fclose(f);
+  return resident * sysconf(_SC_PAGESIZE);
+}
+
+// The same code for all threads: insert until the list is full.
+void thread(void * parameter, int id) {
+  run_t * r = parameter;
+  unsigned int self = (unsigned int)pthread_self();
+  while (list_insert_bounded(&r->list, self, r->max))
+    ;
+}
+
+// Have n_threads threads insert max entries allocated as given into a
+// list without lock, in a child process so that the memory freed by a
+// measure is not reused by the next one. Print the insertions per
+// second, the growth of the resident set size in MB and the time to
+// free the list.
+void measure(int n_threads, list_alloc_t alloc, unsigned int max) {
+  pid_t child = fork();
+  if (child != 0) {
+    int status;
+    waitpid(child, &status, 0);
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) exit(1);
+    return;
+  }
+
+  team_t * team = team_init(n_threads, NULL);
+  run_t r;
+
+  list_init(&r.list, &lock_pthread, alloc);
+  r.max = max;
+  long rss0 = rss();
+  double t0 = now();
+  team_run(team, thread, &r);
+  double t = now() - t0;
+  long grown = rss() - rss0;
+
+  if (list_size(&r.list) != max) {
+    printf("\nwrong list: size %u (%u)\n", list_size(&r.list), max);
+    exit(1);
+  }
+  double t1 = now();
+  list_destroy(&r.list);
+  double t_free = now() - t1;
+  team_destroy(team);
+
+  printf(" %9.2f %7.1f %7.2f", max / t / 1E6, grown / 1E6, t_free * 1E3);
+  fflush(stdout);
+  exit(0);
+}
+
+// Return the number of threads measured after t: 1, 2, 4, ... up to
+// max_threads, then max_threads itself.
+int next_threads(int t, int max_threads) {
+  if (t < max_threads && 2 * t > max_threads) return max_threads;
+  return 2 * t;
+}
+
+// Compare the lock-free insertion of max entries (4M by default) with
+// one malloc per entry and with an arena, with 1, 2, 4, ...
+// max_threads threads (twice the number of processors by default):
+// insertions per second, growth of the resident set size, and time to
+// free the list.
+// Return 0 on success, 1 on error.
+int main(int argc, char * argv[]) {
+  unsigned int max = (argc > 1) ? atol(argv[1]) : 1U << 22;
+  int max_threads = (argc > 2) ? atoi(argv[2]) : 2 * sysconf(_SC_NPROCESSORS_ONLN);
+
+  if ((argc > 3) || (max < 1) || (max_threads < 1)) {
+    printf("Usage : %s [inserts [max_threads]]\n", argv[0]);
+    return 1;
+  }
+
+  printf("inserts=%u\n%8s %25s %25s\n%8s", max, "", "malloc", "arena",
+         "threads");
+  for (int i = 0; i < 2; i++)
+    printf(" %9s %7s %7s", "Mops/s", "RSS MB", "free ms");
+  printf("\n");
+  fflush(stdout);
+  for (int t = 1; t <= max_threads; t = next_threads(t, max_threads)) {
+    printf("%8d", t);
+    fflush(stdout);
+    measure(t, LIST_MALLOC, max);
+    measure(t, LIST_ARENA, max);
+    printf("\n");
+  }
+  return 0;
+}
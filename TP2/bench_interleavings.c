@@ -0,0 +1,105 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "distribution.h"
+#include "topology.h"
+
+// Number of measures of each strategy. The best one is kept.
+#define MEASURES 3
+
+// Return the current value of the monotonic clock in seconds.
+double now() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1E9;
+}
+
+// Return the best time for team to fill x with strategy s, and check
+// that every element was written.
+double measure(team_t * team, unsigned int * x, unsigned int size,
+               distribution_t s, unsigned int chunk) {
+  double best = 0;
+  for (int m = 0; m < MEASURES; m++) {
+    memset(x, 0, size * sizeof(unsigned int));
+    double t0 = now();
+    distribute(team, x, size, s, chunk);
+    double t = now() - t0;
+    if (m == 0 || t < best) best = t;
+    for (unsigned int i = 0; i < size; i++)
+      if (x[i] == 0) {
+        printf("\n%s: x[%u] not written\n", distribution_names[s], i);
+        exit(1);
+      }
+  }
+  return best;
+}
+
+// Return the number of threads measured after t: 1, 2, 4, ... up to
+// max_threads, then max_threads itself.
+int next_threads(int t, int max_threads) {
+  if (t < max_threads && 2 * t > max_threads) return max_threads;
+  return 2 * t;
+}
+
+// Measure the elements filled per second by each strategy with 1, 2,
+// 4, ... max_threads threads, then with two threads pinned in each
+// placement the machine offers.
+// Return 0 on success, 1 on error.
+int main(int argc, char * argv[]) {
+  unsigned int size = (argc > 1) ? atol(argv[1]) : 1U << 24;
+  int max_threads = (argc > 2) ? atoi(argv[2]) : sysconf(_SC_NPROCESSORS_ONLN);
+  unsigned int chunk = (argc > 3) ? atoi(argv[3]) : 1024;
+
+  if ((argc > 4) || (size < 1) || (max_threads < 1) || (chunk < 1)) {
+    printf("Usage : %s [size [max_threads [chunk]]]\n", argv[0]);
+    return 1;
+  }
+  unsigned int * x = malloc(size * sizeof(unsigned int));
+  if (x == NULL) {
+    printf("cannot allocate %u elements\n", size);
+    return 1;
+  }
+
+  printf("size=%u, chunk=%u\n%8s", size, chunk, "threads");
+  for (distribution_t s = 0; s < N_STRATEGIES; s++)
+    printf(" %8s Melt/s", distribution_names[s]);
+  printf("\n");
+
+  for (int t = 1; t <= max_threads; t = next_threads(t, max_threads)) {
+    team_t * team = team_init(t, NULL);
+    printf("%8d", t);
+    for (distribution_t s = 0; s < N_STRATEGIES; s++) {
+      double seconds = measure(team, x, size, s, chunk);
+      printf(" %15.1f", size / seconds / 1E6);
+      fflush(stdout);
+    }
+    printf("\n");
+    team_destroy(team);
+  }
+
+  printf("\n%8s", "2 pinned");
+  for (distribution_t s = 0; s < N_STRATEGIES; s++)
+    printf(" %8s Melt/s", distribution_names[s]);
+  printf("\n");
+  for (placement_t p = PLACE_SMT; p < N_PLACEMENTS; p++) {
+    int cpus[2];
+    printf("%8s", placement_names[p]);
+    if (!placement_cpus(p, 2, cpus)) {
+      printf(" %15s\n", "n/a");
+      continue;
+    }
+    team_t * team = team_init(2, cpus);
+    for (distribution_t s = 0; s < N_STRATEGIES; s++) {
+      double seconds = measure(team, x, size, s, chunk);
+      printf(" %15.1f", size / seconds / 1E6);
+      fflush(stdout);
+    }
+    printf(" (cpus %d, %d)\n", cpus[0], cpus[1]);
+    team_destroy(team);
+  }
+
+  free(x);
+  return 0;
+}
@@ -0,0 +1,94 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+#include "list.h"
+#include "team.h"
+
+// An insertion into the list.
+typedef int (*insert_t)(list_t * l, unsigned int value, unsigned int max);
+
+// A run of the benchmark, shared by the threads.
+typedef struct {
+  list_t list;
+  unsigned int max;
+  insert_t insert;
+} run_t;
+
+// Return the current value of the monotonic clock in seconds.
+double now() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1E9;
+}
+
+// The same code for all threads: insert until the list is full.
+void thread(void * parameter, int id) {
+  run_t * r = parameter;
+  unsigned int self = (unsigned int)pthread_self();
+  while (r->insert(&r->list, self, r->max))
+    ;
+}
+
+// Return the time for the members of team to insert max entries
+// without lock if lock is NULL, under a lock of this kind otherwise,
+// and check the list.
+double measure(team_t * team, const lock_ops_t * lock, unsigned int max) {
+  run_t r;
+  unsigned int count = 0;
+
+  list_init(&r.list, (lock != NULL) ? lock : &lock_pthread, LIST_ARENA);
+  r.max = max;
+  r.insert = (lock != NULL) ? list_insert_bounded_locked : list_insert_bounded;
+  double t0 = now();
+  team_run(team, thread, &r);
+  double t = now() - t0;
+
+  for (list_entry_t * e = atomic_load(&r.list.head); e; e = e->next)
+    count++;
+  if (count != max || list_size(&r.list) != max) {
+    printf("\nwrong list: %u entries, size %u (%u)\n", count,
+           list_size(&r.list), max);
+    exit(1);
+  }
+  list_destroy(&r.list);
+  return t;
+}
+
+// Return the number of threads measured after t: 2, 4, ... up to
+// max_threads, then max_threads itself.
+int next_threads(int t, int max_threads) {
+  if (t < max_threads && 2 * t > max_threads) return max_threads;
+  return 2 * t;
+}
+
+// Measure the insertions per second of max entries (1M by default)
+// into a shared list, without lock and with each kind of lock, with
+// 2, 4, ... max_threads threads (64 by default).
+// Return 0 on success, 1 on error.
+int main(int argc, char * argv[]) {
+  unsigned int max = (argc > 1) ? atol(argv[1]) : 1U << 20;
+  int max_threads = (argc > 2) ? atoi(argv[2]) : 64;
+
+  if ((argc > 3) || (max < 1) || (max_threads < 2)) {
+    printf("Usage : %s [inserts [max_threads >= 2]]\n", argv[0]);
+    return 1;
+  }
+
+  printf("inserts=%u (Mops/s)\n%8s %9s", max, "threads", "lockfree");
+  for (const lock_ops_t ** k = lock_kinds; *k; k++)
+    printf(" %9s", (*k)->name);
+  printf("\n");
+  for (int t = 2; t <= max_threads; t = next_threads(t, max_threads)) {
+    team_t * team = team_init(t, NULL);
+    printf("%8d %9.2f", t, max / measure(team, NULL, max) / 1E6);
+    fflush(stdout);
+    for (const lock_ops_t ** k = lock_kinds; *k; k++) {
+      printf(" %9.2f", max / measure(team, *k, max) / 1E6);
+      fflush(stdout);
+    }
+    printf("\n");
+    team_destroy(team);
+  }
+  return 0;
+}
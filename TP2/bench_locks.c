@@ -0,0 +1,142 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "lock.h"
+#include "team.h"
+
+// Duration of a measure in seconds.
+#define DURATION 0.2
+
+// Number of shared words updated in each critical section.
+#define CRITICAL_WORDS 8
+
+// Acquisitions between two readings of the clock by a thread.
+#define CLOCK_PERIOD 64
+
+// The acquisitions of a thread, alone on its cache line.
+typedef struct {
+  unsigned long count;
+} __attribute__((aligned(64))) worker_t;
+
+// A measure in progress, shared by the threads.
+typedef struct {
+  lock_t lock;
+  double deadline;
+  worker_t * workers;
+  // protected by lock
+  _Alignas(64) unsigned long shared[CRITICAL_WORDS];
+  _Alignas(64) atomic_int stop;
+} run_t;
+
+// Return the current value of the monotonic clock in seconds.
+double now() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1E9;
+}
+
+// The same code for all threads: acquire the lock, update the shared
+// words, release the lock, until the deadline.
+void thread(void * parameter, int id) {
+  run_t * r = parameter;
+  worker_t * w = &r->workers[id];
+  lock_node_t node;
+
+  while (!atomic_load_explicit(&r->stop, memory_order_relaxed)) {
+    lock_acquire(&r->lock, &node);
+    for (int i = 0; i < CRITICAL_WORDS; i++)
+      r->shared[i]++;
+    lock_release(&r->lock, &node);
+    if (++w->count % CLOCK_PERIOD == 0 && now() >= r->deadline)
+      atomic_store_explicit(&r->stop, 1, memory_order_relaxed);
+  }
+}
+
+// Have the members of team contend for a lock of the given kind for
+// DURATION seconds. Print the acquisitions per second, the Jain
+// fairness index of the acquisitions of the threads (1 when they are
+// equal, 1 / n_threads when one thread gets them all) and the ratio
+// of the fewest to the most acquisitions of a thread.
+void measure(team_t * team, const lock_ops_t * kind) {
+  int n_threads = team->n_threads;
+  worker_t * workers = aligned_alloc(64, n_threads * sizeof(worker_t));
+  run_t * r = aligned_alloc(64, sizeof(run_t));
+  double sum = 0, sum2 = 0, min = 0, max = 0;
+
+  lock_init(&r->lock, kind);
+  for (int i = 0; i < CRITICAL_WORDS; i++)
+    r->shared[i] = 0;
+  atomic_init(&r->stop, 0);
+  r->workers = workers;
+  for (int i = 0; i < n_threads; i++)
+    workers[i].count = 0;
+  double t0 = now();
+  r->deadline = t0 + DURATION;
+  team_run(team, thread, r);
+  double t = now() - t0;
+
+  for (int i = 0; i < n_threads; i++) {
+    double c = workers[i].count;
+    sum += c;
+    sum2 += c * c;
+    if (i == 0 || c < min) min = c;
+    if (i == 0 || c > max) max = c;
+  }
+  if (r->shared[0] != sum) {
+    printf("\n%s: %lu updates for %.0f acquisitions\n", kind->name,
+           r->shared[0], sum);
+    exit(1);
+  }
+  printf(" %8.2f %5.2f %5.2f", sum / t / 1E6,
+         (sum2 > 0) ? sum * sum / (n_threads * sum2) : 1,
+         (max > 0) ? min / max : 1);
+  fflush(stdout);
+
+  lock_destroy(&r->lock);
+  free(r);
+  free(workers);
+}
+
+// Return the number of threads measured after t: 1, 2, 4, ... up to
+// max_threads, then max_threads itself.
+int next_threads(int t, int max_threads) {
+  if (t < max_threads && 2 * t > max_threads) return max_threads;
+  return 2 * t;
+}
+
+// Measure each kind of lock (or the one given on the command line)
+// with 1, 2, 4, ... max_threads threads (twice the number of
+// processors by default).
+// Return 0 on success, 1 on error.
+int main(int argc, char * argv[]) {
+  int max_threads = (argc > 1) ? atoi(argv[1]) : 2 * sysconf(_SC_NPROCESSORS_ONLN);
+  const lock_ops_t * only = (argc > 2) ? lock_find(argv[2]) : NULL;
+
+  if ((argc > 3) || (max_threads < 1) || ((argc > 2) && (only == NULL))) {
+    printf("Usage : %s [max_threads [lock]]\n", argv[0]);
+    return 1;
+  }
+
+  printf("%8s", "");
+  for (const lock_ops_t ** k = lock_kinds; *k; k++)
+    if (only == NULL || *k == only)
+      printf(" %20s", (*k)->name);
+  printf("\n%8s", "threads");
+  for (const lock_ops_t ** k = lock_kinds; *k; k++)
+    if (only == NULL || *k == only)
+      printf(" %8s %5s %5s", "Mops/s", "jain", "min");
+  printf("\n");
+
+  for (int t = 1; t <= max_threads; t = next_threads(t, max_threads)) {
+    team_t * team = team_init(t, NULL);
+    printf("%8d", t);
+    for (const lock_ops_t ** k = lock_kinds; *k; k++)
+      if (only == NULL || *k == only)
+        measure(team, *k);
+    printf("\n");
+    team_destroy(team);
+  }
+  return 0;
+}
@@ -0,0 +1,127 @@
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "distribution.h"
+
+#define CACHE_LINE 64
+
+char * distribution_names[] = {"one", "chunk", "static", "segment"};
+
+// The part of the array of a thread (CLAIM_SEGMENT), padded to a
+// cache line so that the threads do not share lines.
+typedef struct {
+  atomic_uint next;
+  unsigned int end;
+} __attribute__((aligned(CACHE_LINE))) cursor_t;
+
+// A fill in progress, shared by the threads.
+typedef struct {
+  unsigned int * x;
+  unsigned int size;
+  unsigned int chunk;
+  distribution_t strategy;
+  unsigned int ** segments;             // CLAIM_SEGMENT, one per thread
+  // Shared counter (CLAIM_ONE), alone on its line
+  _Alignas(CACHE_LINE) atomic_uint counter;
+  cursor_t * cursors;
+} distribution_state_t;
+
+distribution_t distribution_parse(char * name) {
+  distribution_t s;
+  for (s = 0; s < N_STRATEGIES; s++)
+    if (strcmp(name, distribution_names[s]) == 0) break;
+  return s;
+}
+
+// Body of the parallel loops of CLAIM_CHUNK, which hands out chunk
+// indices at a time, and CLAIM_STATIC, which gives each member its
+// whole part at once.
+void distribution_fill(void * parameter, long first, long last, int id) {
+  distribution_state_t * d = parameter;
+  unsigned int self = (unsigned int)pthread_self();
+  long i;
+
+  for (i = first; i < last; i++)
+    d->x[i] = self;
+}
+
+// The code of the members for the other strategies.
+void distribution_member(void * parameter, int id) {
+  distribution_state_t * d = parameter;
+  unsigned int self = (unsigned int)pthread_self();
+  unsigned int i, first;
+  size_t bytes;
+  cursor_t * c;
+
+  switch (d->strategy) {
+  case CLAIM_ONE:
+    // The index returned is checked: several threads may pass a test
+    // of the counter before incrementing it.
+    while ((i = atomic_fetch_add(&d->counter, 1)) < d->size)
+      d->x[i] = self;
+    break;
+
+  case CLAIM_SEGMENT:
+    // The segment is allocated by the thread, so that its pages are
+    // first touched on its node.
+    c = &d->cursors[id];
+    first = atomic_load_explicit(&c->next, memory_order_relaxed);
+    if (first == c->end) break;
+    bytes = (c->end - first) * sizeof(unsigned int);
+    d->segments[id] = aligned_alloc(CACHE_LINE, (bytes + CACHE_LINE - 1)
+                                    / CACHE_LINE * CACHE_LINE);
+    if (d->segments[id] == NULL) {
+      printf("cannot allocate segment %d\n", id);
+      exit(1);
+    }
+    for (i = first; i < c->end; i++)
+      d->segments[id][i - first] = self;
+    break;
+
+  default:
+    break;
+  }
+}
+
+void distribute(team_t * team, unsigned int * x, unsigned int size,
+                distribution_t s, unsigned int chunk) {
+  distribution_state_t d;
+  int n_threads = team->n_threads;
+  int i;
+
+  d.x = x;
+  d.size = size;
+  d.chunk = (chunk > 0) ? chunk : 1;
+  d.strategy = s;
+  d.segments = calloc(n_threads, sizeof(unsigned int *));
+  atomic_init(&d.counter, 0);
+  d.cursors = aligned_alloc(CACHE_LINE, n_threads * sizeof(cursor_t));
+  for (i = 0; i < n_threads; i++) {
+    atomic_init(&d.cursors[i].next, (unsigned long)size * i / n_threads);
+    d.cursors[i].end = (unsigned long)size * (i + 1) / n_threads;
+  }
+
+  // The static parts of team_parallel_for are those of the cursors,
+  // so that CLAIM_STATIC and CLAIM_SEGMENT fill the same parts
+  if (s == CLAIM_CHUNK)
+    team_parallel_for(team, 0, size, d.chunk, TEAM_DYNAMIC,
+                      distribution_fill, &d);
+  else if (s == CLAIM_STATIC)
+    team_parallel_for(team, 0, size, 0, TEAM_STATIC, distribution_fill, &d);
+  else
+    team_run(team, distribution_member, &d);
+
+  // merge the segments
+  for (i = 0; i < n_threads; i++) {
+    if (d.segments[i] == NULL) continue;
+    unsigned int first = atomic_load(&d.cursors[i].next);
+    memcpy(x + first, d.segments[i],
+           (d.cursors[i].end - first) * sizeof(unsigned int));
+    free(d.segments[i]);
+  }
+
+  free(d.segments);
+  free(d.cursors);
+}
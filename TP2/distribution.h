@@ -0,0 +1,37 @@
+#ifndef DISTRIBUTION_H
+#define DISTRIBUTION_H
+
+#include "team.h"
+
+// How the threads share the indices of the array they fill.
+typedef enum {
+  // Claim one index at a time with atomic_fetch_add on a shared
+  // counter. The counter line, and the adjacent elements written by
+  // different threads, bounce between the cores.
+  CLAIM_ONE,
+  // Claim chunk consecutive indices per atomic_fetch_add (a dynamic
+  // team_parallel_for).
+  CLAIM_CHUNK,
+  // Give each thread a contiguous part of the array (a static
+  // team_parallel_for).
+  CLAIM_STATIC,
+  // Give each thread the same part as CLAIM_STATIC, but have it write
+  // a segment of its own, aligned and padded to cache lines, copied
+  // into the array after the threads are joined: no line of the array
+  // is ever written by two threads.
+  CLAIM_SEGMENT,
+  N_STRATEGIES
+} distribution_t;
+
+// Names of the strategies, indexed by distribution_t.
+extern char * distribution_names[];
+
+// Return the strategy of the given name, N_STRATEGIES if unknown.
+distribution_t distribution_parse(char * name);
+
+// Fill x[0..size-1] with the members of team, each storing its
+// pthread_self() in the elements it claims with strategy s. chunk is
+// the number of indices claimed at once by CLAIM_CHUNK.
+void distribute(team_t * team, unsigned int * x, unsigned int size,
+                distribution_t s, unsigned int chunk);
+#endif
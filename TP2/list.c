@@ -0,0 +1,103 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "list.h"
+
+void list_init(list_t * l, const lock_ops_t * lock, list_alloc_t alloc) {
+  atomic_init(&l->head, NULL);
+  atomic_init(&l->size, 0);
+  lock_init(&l->lock, lock);
+  l->alloc = alloc;
+  if (alloc == LIST_ARENA)
+    arena_init(&l->arena, sizeof(list_entry_t));
+}
+
+void list_destroy(list_t * l) {
+  if (l->alloc == LIST_ARENA) {
+    arena_destroy(&l->arena);
+  } else {
+    list_entry_t * e = atomic_load(&l->head);
+    while (e != NULL) {
+      list_entry_t * next = e->next;
+      free(e);
+      e = next;
+    }
+  }
+  atomic_store(&l->head, NULL);
+  atomic_store(&l->size, 0);
+  lock_destroy(&l->lock);
+}
+
+// Allocate and initialize a new entry of l. Exit if out of memory.
+static list_entry_t * list_entry_new(list_t * l, unsigned int value) {
+  list_entry_t * e;
+  if (l->alloc == LIST_ARENA)
+    e = (list_entry_t *)arena_alloc(&l->arena);
+  else
+    e = (list_entry_t *)malloc(sizeof(list_entry_t));
+  if (e == NULL) {
+    printf("cannot allocate list entry\n");
+    exit(1);
+  }
+  e->value = value;
+  e->next = NULL;
+  return e;
+}
+
+// Free an entry of l that was not inserted.
+static void list_entry_free(list_t * l, list_entry_t * e) {
+  if (l->alloc == LIST_ARENA)
+    arena_unalloc(&l->arena, e);
+  else
+    free(e);
+}
+
+int list_insert_bounded(list_t * l, unsigned int value, unsigned int max) {
+  // allocate before reserving a slot, so that a reserved slot is
+  // always filled
+  list_entry_t * e = list_entry_new(l, value);
+  unsigned int size = atomic_load_explicit(&l->size, memory_order_relaxed);
+
+  // reserve a slot
+  do {
+    if (size >= max) {
+      list_entry_free(l, e);
+      return 0;
+    }
+  } while (!atomic_compare_exchange_weak_explicit(&l->size, &size, size + 1,
+                                                  memory_order_relaxed,
+                                                  memory_order_relaxed));
+
+  // push the entry: entries are never removed concurrently, so the
+  // head cannot be recycled under the CAS (no ABA problem)
+  e->next = atomic_load_explicit(&l->head, memory_order_relaxed);
+  while (!atomic_compare_exchange_weak_explicit(&l->head, &e->next, e,
+                                                memory_order_release,
+                                                memory_order_relaxed))
+    ;
+  return 1;
+}
+
+int list_insert_bounded_locked(list_t * l, unsigned int value,
+                               unsigned int max) {
+  // allocate outside of the critical section
+  list_entry_t * e = list_entry_new(l, value);
+  lock_node_t node;
+  unsigned int size;
+
+  lock_acquire(&l->lock, &node);
+  size = atomic_load_explicit(&l->size, memory_order_relaxed);
+  if (size >= max) {
+    lock_release(&l->lock, &node);
+    list_entry_free(l, e);
+    return 0;
+  }
+  atomic_store_explicit(&l->size, size + 1, memory_order_relaxed);
+  e->next = atomic_load_explicit(&l->head, memory_order_relaxed);
+  atomic_store_explicit(&l->head, e, memory_order_relaxed);
+  lock_release(&l->lock, &node);
+  return 1;
+}
+
+unsigned int list_size(list_t * l) {
+  return atomic_load(&l->size);
+}
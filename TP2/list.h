@@ -0,0 +1,52 @@
+#ifndef LIST_H
+#define LIST_H
+
+#include <stdatomic.h>
+#include "arena.h"
+#include "lock.h"
+
+typedef struct list_entry_t {
+  unsigned int value;
+  struct list_entry_t * next;
+} list_entry_t;
+
+// The allocation of the entries of a list.
+typedef enum {
+  LIST_MALLOC,                          // one malloc per entry
+  LIST_ARENA,                           // per-thread chunks of an arena
+} list_alloc_t;
+
+// A list shared by threads, new values being inserted at its head.
+// The head, the element count and the lock are on separate cache
+// lines.
+typedef struct {
+  _Atomic(list_entry_t *) head;
+  _Alignas(64) atomic_uint size;
+  _Alignas(64) lock_t lock;
+  list_alloc_t alloc;
+  arena_t arena;                        // if alloc is LIST_ARENA
+} list_t;
+
+// Initialize an empty list, protected by a lock of the given kind in
+// list_insert_bounded_locked, its entries being allocated as given.
+void list_init(list_t * l, const lock_ops_t * lock, list_alloc_t alloc);
+
+// Free the entries of a list: one by one with LIST_MALLOC, chunk by
+// chunk with LIST_ARENA.
+void list_destroy(list_t * l);
+
+// Insert value at the head of l unless l already holds max entries,
+// without lock: the entry is allocated, a slot is reserved by a CAS
+// loop on the count, then the entry is pushed by a CAS loop on the
+// head (Treiber stack). Return 1 if value was inserted, 0 if the list
+// was full. Exit if out of memory.
+int list_insert_bounded(list_t * l, unsigned int value, unsigned int max);
+
+// Same as list_insert_bounded, the count and the head being updated
+// under the lock of the list.
+int list_insert_bounded_locked(list_t * l, unsigned int value,
+                               unsigned int max);
+
+// Return the number of entries of l, in constant time.
+unsigned int list_size(list_t * l);
+#endif
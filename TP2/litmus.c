@@ -0,0 +1,195 @@
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "team.h"
+#include "litmus.h"
+
+char * litmus_order_names[] = {"relaxed", "acqrel", "seqcst", "fence"};
+
+litmus_order_t litmus_order_parse(char * name) {
+  litmus_order_t o = 0;
+  while (o < N_ORDERS && strcmp(litmus_order_names[o], name) != 0)
+    o++;
+  return o;
+}
+
+// The memory orders of the stores and loads and the fence between two
+// accesses of a thread, for each ordering. They must be constants for
+// the compiler to emit the relaxed forms.
+#define ST_relaxed memory_order_relaxed
+#define LD_relaxed memory_order_relaxed
+#define FENCE_relaxed (void)0
+#define ST_acqrel memory_order_release
+#define LD_acqrel memory_order_acquire
+#define FENCE_acqrel (void)0
+#define ST_seqcst memory_order_seq_cst
+#define LD_seqcst memory_order_seq_cst
+#define FENCE_seqcst (void)0
+#define ST_fence memory_order_relaxed
+#define LD_fence memory_order_relaxed
+#define FENCE_fence atomic_thread_fence(memory_order_seq_cst)
+
+#define STORE(l, O) atomic_store_explicit(&t->l, 1, ST_##O)
+#define LOAD(l, O) atomic_load_explicit(&t->l, LD_##O)
+
+// Define the threads of all the patterns with ordering O.
+#define DEFINE_THREADS(O)                                               \
+  static void sb0_##O(litmus_instance_t * t) {                          \
+    STORE(x, O); FENCE_##O; t->r[0] = LOAD(y, O);                       \
+  }                                                                     \
+  static void sb1_##O(litmus_instance_t * t) {                          \
+    STORE(y, O); FENCE_##O; t->r[1] = LOAD(x, O);                       \
+  }                                                                     \
+  static void mp0_##O(litmus_instance_t * t) {                          \
+    STORE(x, O); FENCE_##O; STORE(y, O);                                \
+  }                                                                     \
+  static void mp1_##O(litmus_instance_t * t) {                          \
+    t->r[0] = LOAD(y, O); FENCE_##O; t->r[1] = LOAD(x, O);              \
+  }                                                                     \
+  static void lb0_##O(litmus_instance_t * t) {                          \
+    t->r[0] = LOAD(x, O); FENCE_##O; STORE(y, O);                       \
+  }                                                                     \
+  static void lb1_##O(litmus_instance_t * t) {                          \
+    t->r[1] = LOAD(y, O); FENCE_##O; STORE(x, O);                       \
+  }                                                                     \
+  static void iriw0_##O(litmus_instance_t * t) {                        \
+    STORE(x, O);                                                        \
+  }                                                                     \
+  static void iriw1_##O(litmus_instance_t * t) {                        \
+    STORE(y, O);                                                        \
+  }                                                                     \
+  static void iriw2_##O(litmus_instance_t * t) {                        \
+    t->r[0] = LOAD(x, O); FENCE_##O; t->r[1] = LOAD(y, O);              \
+  }                                                                     \
+  static void iriw3_##O(litmus_instance_t * t) {                        \
+    t->r[2] = LOAD(y, O); FENCE_##O; t->r[3] = LOAD(x, O);              \
+  }
+
+DEFINE_THREADS(relaxed)
+DEFINE_THREADS(acqrel)
+DEFINE_THREADS(seqcst)
+DEFINE_THREADS(fence)
+
+// The threads of a pattern with each ordering, in litmus_order_t order.
+#define BY_ORDER(P) {P(relaxed), P(acqrel), P(seqcst), P(fence)}
+#define SB(O) {sb0_##O, sb1_##O}
+#define MP(O) {mp0_##O, mp1_##O}
+#define LB(O) {lb0_##O, lb1_##O}
+#define IRIW(O) {iriw0_##O, iriw1_##O, iriw2_##O, iriw3_##O}
+
+const litmus_pattern_t litmus_sb =
+  {"sb", "x=1; r0=y || y=1; r1=x", 2, 2, 0x0, BY_ORDER(SB)};
+const litmus_pattern_t litmus_mp =
+  {"mp", "x=1; y=1 || r0=y; r1=x", 2, 2, 0x1, BY_ORDER(MP)};
+const litmus_pattern_t litmus_lb =
+  {"lb", "r0=x; y=1 || r1=y; x=1", 2, 2, 0x3, BY_ORDER(LB)};
+const litmus_pattern_t litmus_iriw =
+  {"iriw", "x=1 || y=1 || r0=x; r1=y || r2=y; r3=x", 4, 4, 0x5,
+   BY_ORDER(IRIW)};
+
+const litmus_pattern_t * litmus_patterns[] =
+  {&litmus_sb, &litmus_mp, &litmus_lb, &litmus_iriw, NULL};
+
+const litmus_pattern_t * litmus_find(char * name) {
+  for (const litmus_pattern_t ** p = litmus_patterns; *p; p++)
+    if (strcmp((*p)->name, name) == 0) return *p;
+  return NULL;
+}
+
+// A run of a pattern, shared by its threads.
+typedef struct {
+  const litmus_pattern_t * pattern;
+  const litmus_thread_t * threads;
+  litmus_instance_t * instances;
+  int batch;
+  unsigned long rounds;
+  unsigned long * histogram;
+  team_t * team;
+} run_t;
+
+// A thread created for a single instance.
+typedef struct {
+  run_t * run;
+  int id;
+  pthread_t thread;
+} worker_t;
+
+// Count the outcomes of n instances into histogram and reset them.
+static void collect(const litmus_pattern_t * p, litmus_instance_t * t,
+                    int n, unsigned long * histogram) {
+  for (int i = 0; i < n; i++) {
+    unsigned int outcome = 0;
+    for (int j = 0; j < p->n_registers; j++)
+      outcome |= (t[i].r[j] != 0) << j;
+    histogram[outcome]++;
+    atomic_store_explicit(&t[i].x, 0, memory_order_relaxed);
+    atomic_store_explicit(&t[i].y, 0, memory_order_relaxed);
+  }
+}
+
+// A member of the team: run its part of each batch between two
+// barriers, member 0 collecting the outcomes.
+static void persistent(void * parameter, int id) {
+  run_t * r = parameter;
+  litmus_thread_t code = r->threads[id];
+
+  for (unsigned long i = 0; i < r->rounds; i++) {
+    team_barrier(r->team, id);
+    for (int j = 0; j < r->batch; j++)
+      code(&r->instances[j]);
+    team_barrier(r->team, id);
+    if (id == 0)
+      collect(r->pattern, r->instances, r->batch, r->histogram);
+  }
+}
+
+// A thread created for a single instance.
+static void * once(void * parameter) {
+  worker_t * w = parameter;
+  w->run->threads[w->id](w->run->instances);
+  return NULL;
+}
+
+unsigned long litmus_run(const litmus_pattern_t * p, litmus_order_t o,
+                         unsigned long trials, int batch,
+                         unsigned long * histogram) {
+  run_t * r = malloc(sizeof(run_t));
+  worker_t workers[LITMUS_THREADS];
+  int size = (batch > 0) ? batch : 1;
+
+  r->pattern = p;
+  r->threads = p->threads[o];
+  r->instances = aligned_alloc(64, size * sizeof(litmus_instance_t));
+  r->batch = size;
+  r->rounds = (trials + size - 1) / size;
+  r->histogram = histogram;
+  for (int i = 0; i < size; i++) {
+    atomic_init(&r->instances[i].x, 0);
+    atomic_init(&r->instances[i].y, 0);
+  }
+  for (int i = 0; i < (1 << p->n_registers); i++)
+    histogram[i] = 0;
+  for (int i = 0; i < p->n_threads; i++) {
+    workers[i].run = r;
+    workers[i].id = i;
+  }
+
+  if (batch > 0) {
+    r->team = team_init(p->n_threads, NULL);
+    team_run(r->team, persistent, r);
+    team_destroy(r->team);
+  } else {
+    for (unsigned long k = 0; k < r->rounds; k++) {
+      for (int i = 0; i < p->n_threads; i++)
+        pthread_create(&workers[i].thread, NULL, &once, &workers[i]);
+      for (int i = 0; i < p->n_threads; i++)
+        pthread_join(workers[i].thread, NULL);
+      collect(p, r->instances, 1, histogram);
+    }
+  }
+
+  unsigned long n = r->rounds * size;
+  free(r->instances);
+  free(r);
+  return n;
+}
@@ -0,0 +1,82 @@
+#ifndef LITMUS_H
+#define LITMUS_H
+
+#include <stdatomic.h>
+
+// Largest number of threads and registers of a pattern.
+#define LITMUS_THREADS 4
+#define LITMUS_REGISTERS 4
+
+// How the accesses of a pattern are ordered.
+typedef enum {
+  // Relaxed atomic loads and stores: any reordering is allowed.
+  ORDER_RELAXED,
+  // Release stores and acquire loads.
+  ORDER_ACQREL,
+  // Sequentially consistent loads and stores.
+  ORDER_SEQCST,
+  // Relaxed loads and stores separated by a sequentially consistent
+  // fence.
+  ORDER_FENCE,
+  N_ORDERS
+} litmus_order_t;
+
+// Names of the orderings, indexed by litmus_order_t.
+extern char * litmus_order_names[];
+
+// Return the ordering of the given name, N_ORDERS if unknown.
+litmus_order_t litmus_order_parse(char * name);
+
+// An instance of a test: the shared locations, each alone on its
+// cache line, and the registers the threads load them into.
+typedef struct {
+  _Alignas(64) atomic_int x;
+  _Alignas(64) atomic_int y;
+  _Alignas(64) int r[LITMUS_REGISTERS];
+} litmus_instance_t;
+
+// The code of one thread of a pattern on an instance.
+typedef void (*litmus_thread_t)(litmus_instance_t * t);
+
+// A litmus test. Its outcome is the values (0 or 1) of its registers,
+// register i giving bit i.
+typedef struct {
+  char * name;
+  char * code;
+  int n_threads;
+  int n_registers;
+  // the outcome forbidden under sequential consistency
+  unsigned int relaxed;
+  litmus_thread_t threads[N_ORDERS][LITMUS_THREADS];
+} litmus_pattern_t;
+
+// store buffering: x=1; r0=y || y=1; r1=x
+extern const litmus_pattern_t litmus_sb;
+// message passing: x=1; y=1 || r0=y; r1=x
+extern const litmus_pattern_t litmus_mp;
+// load buffering: r0=x; y=1 || r1=y; x=1
+extern const litmus_pattern_t litmus_lb;
+// independent reads of independent writes:
+// x=1 || y=1 || r0=x; r1=y || r2=y; r3=x
+extern const litmus_pattern_t litmus_iriw;
+
+// All the patterns, terminated by NULL.
+extern const litmus_pattern_t * litmus_patterns[];
+
+// Return the pattern of the given name, NULL if unknown.
+const litmus_pattern_t * litmus_find(char * name);
+
+// Run trials instances of pattern p with ordering o, and count the
+// occurrences of each outcome into histogram (1 << p->n_registers
+// counters). The threads of the pattern are started once, as a team.
+// For each batch of instances they meet at the spinning barrier of
+// the team, run the instances in the same order, and meet again
+// before thread 0 counts the outcomes and resets the instances. If
+// batch is 0, new threads are created and joined for every instance
+// instead.
+// Return the number of instances run (trials rounded up to a multiple
+// of batch).
+unsigned long litmus_run(const litmus_pattern_t * p, litmus_order_t o,
+                         unsigned long trials, int batch,
+                         unsigned long * histogram);
+#endif
@@ -0,0 +1,141 @@
+#include <string.h>
+#include "lock.h"
+
+// Longest backoff of ttas, in pause instructions.
+#define BACKOFF_MAX 1024
+
+static void flag_init(lock_t * l) {
+  atomic_init(&l->flag, 0);
+}
+
+static void nothing(lock_t * l) {
+}
+
+static void tas_acquire(lock_t * l, lock_node_t * node) {
+  int spins = 0;
+  while (atomic_exchange_explicit(&l->flag, 1, memory_order_acquire))
+    spin_wait(&spins);
+}
+
+static void flag_release(lock_t * l, lock_node_t * node) {
+  atomic_store_explicit(&l->flag, 0, memory_order_release);
+}
+
+static void ttas_acquire(lock_t * l, lock_node_t * node) {
+  int spins = 0, backoff = 1;
+  for (;;) {
+    // wait until the lock looks free, reading a shared copy of its line
+    while (atomic_load_explicit(&l->flag, memory_order_relaxed))
+      spin_wait(&spins);
+    if (!atomic_exchange_explicit(&l->flag, 1, memory_order_acquire))
+      return;
+    // another thread got it first: back off before trying again
+    for (int i = 0; i < backoff; i++)
+      cpu_relax();
+    if (backoff < BACKOFF_MAX) backoff *= 2;
+  }
+}
+
+static void ticket_init(lock_t * l) {
+  atomic_init(&l->ticket.next, 0);
+  atomic_init(&l->ticket.serving, 0);
+}
+
+static void ticket_acquire(lock_t * l, lock_node_t * node) {
+  int spins = 0;
+  unsigned int ticket = atomic_fetch_add_explicit(&l->ticket.next, 1,
+                                                  memory_order_relaxed);
+  while (atomic_load_explicit(&l->ticket.serving, memory_order_acquire)
+         != ticket)
+    spin_wait(&spins);
+}
+
+static void ticket_release(lock_t * l, lock_node_t * node) {
+  unsigned int serving = atomic_load_explicit(&l->ticket.serving,
+                                              memory_order_relaxed);
+  atomic_store_explicit(&l->ticket.serving, serving + 1,
+                        memory_order_release);
+}
+
+static void mcs_init(lock_t * l) {
+  atomic_init(&l->tail, NULL);
+}
+
+static void mcs_acquire(lock_t * l, lock_node_t * node) {
+  int spins = 0;
+  lock_node_t * previous;
+
+  atomic_store_explicit(&node->next, NULL, memory_order_relaxed);
+  atomic_store_explicit(&node->locked, 1, memory_order_relaxed);
+  previous = atomic_exchange_explicit(&l->tail, node, memory_order_acq_rel);
+  if (previous == NULL) return;
+
+  // queue behind previous and spin on our own node
+  atomic_store_explicit(&previous->next, node, memory_order_release);
+  while (atomic_load_explicit(&node->locked, memory_order_acquire))
+    spin_wait(&spins);
+}
+
+static void mcs_release(lock_t * l, lock_node_t * node) {
+  int spins = 0;
+  lock_node_t * next = atomic_load_explicit(&node->next, memory_order_acquire);
+
+  if (next == NULL) {
+    // no known successor: free the lock if we are still the tail
+    lock_node_t * expected = node;
+    if (atomic_compare_exchange_strong_explicit(&l->tail, &expected, NULL,
+                                                memory_order_release,
+                                                memory_order_relaxed))
+      return;
+    // a successor is queuing: wait until it links itself
+    while ((next = atomic_load_explicit(&node->next, memory_order_acquire))
+           == NULL)
+      spin_wait(&spins);
+  }
+  atomic_store_explicit(&next->locked, 0, memory_order_release);
+}
+
+static void mutex_init(lock_t * l) {
+  pthread_mutex_init(&l->mutex, NULL);
+}
+
+static void mutex_acquire(lock_t * l, lock_node_t * node) {
+  pthread_mutex_lock(&l->mutex);
+}
+
+static void mutex_release(lock_t * l, lock_node_t * node) {
+  pthread_mutex_unlock(&l->mutex);
+}
+
+static void mutex_destroy(lock_t * l) {
+  pthread_mutex_destroy(&l->mutex);
+}
+
+const lock_ops_t lock_tas =
+  {"tas", flag_init, tas_acquire, flag_release, nothing};
+const lock_ops_t lock_ttas =
+  {"ttas", flag_init, ttas_acquire, flag_release, nothing};
+const lock_ops_t lock_ticket =
+  {"ticket", ticket_init, ticket_acquire, ticket_release, nothing};
+const lock_ops_t lock_mcs =
+  {"mcs", mcs_init, mcs_acquire, mcs_release, nothing};
+const lock_ops_t lock_pthread =
+  {"pthread", mutex_init, mutex_acquire, mutex_release, mutex_destroy};
+
+const lock_ops_t * lock_kinds[] =
+  {&lock_tas, &lock_ttas, &lock_ticket, &lock_mcs, &lock_pthread, NULL};
+
+const lock_ops_t * lock_find(char * name) {
+  for (const lock_ops_t ** k = lock_kinds; *k; k++)
+    if (strcmp((*k)->name, name) == 0) return *k;
+  return NULL;
+}
+
+void lock_init(lock_t * l, const lock_ops_t * ops) {
+  l->ops = ops;
+  ops->init(l);
+}
+
+void lock_destroy(lock_t * l) {
+  l->ops->destroy(l);
+}
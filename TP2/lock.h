@@ -0,0 +1,71 @@
+#ifndef LOCK_H
+#define LOCK_H
+
+#include <stdatomic.h>
+#include <pthread.h>
+#include "spin.h"
+
+// A node of the queue of the MCS lock. Each thread acquiring a lock
+// brings its own node, and gives the same one back to release it.
+// The other locks ignore it.
+typedef struct lock_node_t {
+  _Atomic(struct lock_node_t *) next;
+  atomic_int locked;
+} __attribute__((aligned(64))) lock_node_t;
+
+struct lock_ops_t;
+
+// A lock of any kind, selected at runtime by its operations.
+typedef struct {
+  const struct lock_ops_t * ops;
+  union {
+    atomic_int flag;                    // tas, ttas
+    struct {
+      atomic_uint next;                 // next ticket handed out
+      atomic_uint serving;              // ticket allowed to enter
+    } ticket;
+    _Atomic(lock_node_t *) tail;        // mcs
+    pthread_mutex_t mutex;              // pthread
+  };
+} lock_t;
+
+// The implementation of a kind of lock.
+typedef struct lock_ops_t {
+  char * name;
+  void (*init)(lock_t * l);
+  void (*acquire)(lock_t * l, lock_node_t * node);
+  void (*release)(lock_t * l, lock_node_t * node);
+  void (*destroy)(lock_t * l);
+} lock_ops_t;
+
+// test-and-set: spin on an atomic exchange.
+extern const lock_ops_t lock_tas;
+// test-and-test-and-set: spin reading the flag, exchange when it is
+// free, back off exponentially after a failed exchange.
+extern const lock_ops_t lock_ttas;
+// ticket lock: FIFO, every waiter spins on the same counter.
+extern const lock_ops_t lock_ticket;
+// MCS queue lock: FIFO, every waiter spins on its own node.
+extern const lock_ops_t lock_mcs;
+// pthread_mutex_t: spins briefly, then sleeps in the kernel.
+extern const lock_ops_t lock_pthread;
+
+// All the kinds of lock, terminated by NULL.
+extern const lock_ops_t * lock_kinds[];
+
+// Return the kind of lock of the given name, NULL if unknown.
+const lock_ops_t * lock_find(char * name);
+
+// Initialize l as a free lock of the given kind.
+void lock_init(lock_t * l, const lock_ops_t * ops);
+
+void lock_destroy(lock_t * l);
+
+static inline void lock_acquire(lock_t * l, lock_node_t * node) {
+  l->ops->acquire(l, node);
+}
+
+static inline void lock_release(lock_t * l, lock_node_t * node) {
+  l->ops->release(l, node);
+}
+#endif
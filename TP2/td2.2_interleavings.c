@@ -1,38 +1,47 @@
-#include <stdatomic.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <pthread.h>
+#include "distribution.h"
+#include "topology.h"
 
 #define SIZE 2000
 
 // A shared array of unsigned integers (non-atomic, no memory model specified)
 static unsigned int x[SIZE] = {0,};
 
-// A shared counter (atomic, with memory order sequential consistency)
-static atomic_uint counter = 0;
-
-// The same code for all threads.
-void *thread(void *parameter)
+// Create and start threads (two by default) filling x and see how
+// their executions interleave. The strategy distributing the indices
+// of x among the threads (one at a time by default), the number of
+// indices claimed at once by the "chunk" strategy and the placement
+// of the threads (not pinned by default) can be given on the command
+// line.
+// Return 0 on success, 1 on error.
+int main(int argc, char * argv[])
 {
-  while(counter < SIZE)
+  int n_threads = (argc > 1) ? atoi(argv[1]) : 2;
+  distribution_t s = (argc > 2) ? distribution_parse(argv[2]) : CLAIM_ONE;
+  unsigned int chunk = (argc > 3) ? atoi(argv[3]) : 64;
+  placement_t p = (argc > 4) ? placement_parse(argv[4]) : PLACE_ANY;
+
+  if ((argc > 5) || (n_threads < 1) || (s == N_STRATEGIES) || (chunk < 1) ||
+      (p == N_PLACEMENTS))
   {
-    x[atomic_fetch_add(&counter, 1)] = (unsigned int)pthread_self();
+    printf("Usage : %s [threads [one|chunk|static|segment [chunk "
+           "[any|smt|socket|cross]]]]\n", argv[0]);
+    return 1;
+  }
+  int *cpus = (int *)malloc(n_threads * sizeof(int));
+  if ((p != PLACE_ANY) && !placement_cpus(p, n_threads, cpus))
+  {
+    printf("no processors placed as %s\n", placement_names[p]);
+    return 1;
   }
-  return NULL;
-}
-
-// Create and start two threads and see how their executions interleave.
-// Always returns 0.
-int main()
-{
-  // create the two threads
-  // create the two threads.
-  pthread_t a,b;
-  pthread_create(&a, NULL, &thread, NULL);
-  pthread_create(&b, NULL, &thread, NULL);
 
-  // wait for both threads to finish
-  pthread_join(a, NULL);
-  pthread_join(b, NULL);
+  // create the threads, fill x and wait for them to finish
+  team_t *team = team_init(n_threads, (p != PLACE_ANY) ? cpus : NULL);
+  distribute(team, x, SIZE, s, chunk);
+  team_destroy(team);
+  free(cpus);
 
   // print the contents of the shared array
   for(unsigned int i = 0; i < SIZE; i++)
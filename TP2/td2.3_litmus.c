@@ -0,0 +1,91 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "litmus.h"
+
+// Return the current value of the monotonic clock in seconds.
+double now()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1E9;
+}
+
+// Run trials instances of pattern p with ordering o, batch instances
+// per barrier (or new threads per instance if batch is 0), and print
+// the trials per second and the histogram of the outcomes, the one
+// forbidden under sequential consistency being marked with a *.
+void test(const litmus_pattern_t *p, litmus_order_t o, unsigned long trials,
+          int batch)
+{
+  unsigned long histogram[1 << LITMUS_REGISTERS];
+
+  double t0 = now();
+  unsigned long n = litmus_run(p, o, trials, batch, histogram);
+  double t = now() - t0;
+
+  printf("%s %s (%s): %lu trials in %.2f s, %.2f M/s\n", p->name,
+         litmus_order_names[o], p->code, n, t, n / t / 1E6);
+  for(unsigned int outcome = 0; outcome < (1U << p->n_registers); outcome++)
+  {
+    printf(" ");
+    for(int i = 0; i < p->n_registers; i++)
+      printf(" r%d=%u", i, (outcome >> i) & 1);
+    printf(" %12lu%s\n", histogram[outcome],
+           (outcome == p->relaxed) ? " *" : "");
+  }
+}
+
+// Print the usage of the program.
+void usage(char *name)
+{
+  printf("Usage : %s [all", name);
+  for(const litmus_pattern_t **p = litmus_patterns; *p; p++)
+    printf("|%s", (*p)->name);
+  printf(" [all");
+  for(litmus_order_t o = 0; o < N_ORDERS; o++)
+    printf("|%s", litmus_order_names[o]);
+  printf(" [trials [batch|create]]]]\n");
+}
+
+// Run litmus tests (store buffering with relaxed accesses by default,
+// or the pattern and ordering given on the command line, "all" for
+// each of them) and print the histograms of their outcomes. The
+// threads of a test are started once and meet at a barrier around
+// each batch of instances (100 by default), or are created for each
+// instance with "create", as td2.3_storebuffer does.
+// Returns 0 on success, 1 on error.
+int main(int argc, char *argv[])
+{
+  char *pattern = (argc > 1) ? argv[1] : "sb";
+  char *order = (argc > 2) ? argv[2] : "relaxed";
+  unsigned long trials = (argc > 3) ? atol(argv[3]) : 1000000;
+  int batch = (argc > 4) ? atoi(argv[4]) : 100;
+  const litmus_pattern_t *only = litmus_find(pattern);
+  litmus_order_t o = litmus_order_parse(order);
+
+  if ((argc > 4) && (strcmp(argv[4], "create") == 0))
+    batch = 0;
+  if ((argc > 5) || (trials < 1) || (batch < 0) ||
+      ((only == NULL) && (strcmp(pattern, "all") != 0)) ||
+      ((o == N_ORDERS) && (strcmp(order, "all") != 0)) ||
+      ((argc > 4) && (batch == 0) && (strcmp(argv[4], "create") != 0)))
+  {
+    usage(argv[0]);
+    return 1;
+  }
+
+  for(const litmus_pattern_t **p = litmus_patterns; *p; p++)
+  {
+    if ((only != NULL) && (*p != only))
+      continue;
+    for(litmus_order_t k = 0; k < N_ORDERS; k++)
+    {
+      if ((o == N_ORDERS) || (k == o))
+        test(*p, k, trials, batch);
+    }
+  }
+
+  return 0;
+}
@@ -1,6 +1,7 @@
 #include <stdatomic.h>
 #include <stdio.h>
 #include <pthread.h>
+#include "team.h"
 
 // Two shared variables (neither atomic, nor with a well specified memory order)
 static int x = 0;
@@ -29,26 +30,32 @@ void *threadB(void *parameter)
   return NULL;
 }
 
-// Create and start two threads over and over again and check the outcome.
+// Member 0 of the team runs threadA, member 1 threadB.
+void member(void *parameter, int id)
+{
+  if (id == 0)
+    threadA(parameter);
+  else
+    threadB(parameter);
+}
+
+// Start two threads once, then run them over and over again and check
+// the outcome.
 // Always returns 0.
 int main()
 {
+  team_t *team = team_init(2, NULL);
   unsigned int i = 0;
   while(++i)
   {
-    // create the two threads
-    pthread_t a,b;
-    pthread_create(&a, NULL, &threadA, NULL);
-    pthread_create(&b, NULL, &threadB, NULL);
-
-    // wait for both threads to finish
-    pthread_join(a, NULL);
-    pthread_join(b, NULL);
+    // run the two threads and wait for both of them to finish
+    team_run(team, member, NULL);
 
     // Can this happen? Should this happen?
     if (counter == 2)
     {
       printf("He! (%d)\n", i);
+      team_destroy(team);
       return 0;
     }
 
@@ -58,5 +65,6 @@ int main()
     counter = 0;
   }
 
+  team_destroy(team);
   return 0;
 }
\ No newline at end of file
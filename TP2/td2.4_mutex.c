@@ -1,97 +1,72 @@
-#include <stdatomic.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <pthread.h>
+#include "list.h"
+#include "team.h"
 
 static const unsigned int SIZE = 2000;
 
-typedef struct my_list_entry_t
-{
-  unsigned int value;
-  struct my_list_entry_t *next;
-} my_list_entry_t;
-
-// A shared list of thread IDs.
-my_list_entry_t *x = NULL;
+// A shared list of thread IDs, its entries allocated from an arena.
+list_t x;
 
-// An atomic counter variable used to track the number of list insertions
-// executed.
-atomic_uint insertion_counter = 0;
+// The insertion used by the threads: lock-free, or under the lock of
+// the list.
+int (*insert)(list_t *l, unsigned int value, unsigned int max) =
+  list_insert_bounded;
 
-// insert a new value at the head of the linked list.
-my_list_entry_t *my_list_insert(my_list_entry_t *head, unsigned int value)
+// The same code for all threads: insert the thread ID until the list
+// holds SIZE entries. The size query is O(1).
+void thread(void *parameter, int id)
 {
-  // allocate new list entry
-  my_list_entry_t *new_entry;
-  new_entry = (my_list_entry_t *)malloc(sizeof(my_list_entry_t));
-
-  // initialize new list entry
-  new_entry->next = head;
-  new_entry->value = value;
-
-  // track number of insertions
-  atomic_fetch_add(&insertion_counter, 1);
-
-  // return new entry as new first element of the list
-  return new_entry;
+  while(insert(&x, (unsigned int)pthread_self(), SIZE))
+    ;
 }
 
-// count the number of elements in the linked list.
-unsigned int my_list_size(my_list_entry_t *head)
+// Print the usage of the program.
+void usage(char *name)
 {
-  unsigned int counter = 0;
-  while(head != NULL)
-  {
-    counter++;
-    head = head->next;
-  }
-
-  return counter;
+  printf("Usage : %s [threads [lockfree", name);
+  for(const lock_ops_t **k = lock_kinds; *k; k++)
+    printf("|%s", (*k)->name);
+  printf("]]\n");
 }
 
-// The same code for all threads.
-void *thread(void *parameter)
+// Create and start threads (two by default, or the number given on
+// the command line) and observe the interleavings of their
+// insertions into a shared list, synchronized without lock (by
+// default) or by the kind of lock given on the command line.
+// Returns 0 on success, 1 on error.
+int main(int argc, char *argv[])
 {
-  unsigned int done = 0;
-  while(!done)
+  int n_threads = (argc > 1) ? atoi(argv[1]) : 2;
+  char *kind = (argc > 2) ? argv[2] : "lockfree";
+  const lock_ops_t *lock = lock_find(kind);
+
+  if ((argc > 3) || (n_threads < 1) ||
+      ((lock == NULL) && (strcmp(kind, "lockfree") != 0)))
   {
-    if (my_list_size(x) < SIZE)
-    {
-      x = my_list_insert(x, (unsigned int)pthread_self());
-    }
-    else
-    {
-      done = 1;
-    }
+    usage(argv[0]);
+    return 1;
   }
+  if (lock != NULL)
+    insert = list_insert_bounded_locked;
+  list_init(&x, (lock != NULL) ? lock : &lock_pthread, LIST_ARENA);
 
-  // should never be reached
-  return NULL;
-}
+  // create the threads, run them and wait for all of them to finish
+  team_t *team = team_init(n_threads, NULL);
+  team_run(team, thread, NULL);
+  team_destroy(team);
 
-// Create and start two threads and observe the interleavings, synchronizing 
-// accesses to a shared list using a home-brew mutex implementation.
-// Always returns 0.
-int main()
-{
-  // create the two threads
-  pthread_t a,b;
-  pthread_create(&a, NULL, &thread, NULL);
-  pthread_create(&b, NULL, &thread, NULL);
-
-  // wait for both threads to finish
-  pthread_join(a, NULL);
-  pthread_join(b, NULL);
-
-  // print the contents of the shared lis
+  // print the contents of the shared list
   unsigned int i = 0;
-  while(x)
+  for(list_entry_t *e = atomic_load(&x.head); e; e = e->next)
   {
-    printf("x[%u] = %x\n", i++, x->value);
-    x=x->next;
+    printf("x[%u] = %x\n", i++, e->value);
   }
 
-  printf("insertions: %u (%u)\n", insertion_counter, SIZE);
+  printf("insertions: %u (%u)\n", list_size(&x), SIZE);
 
+  list_destroy(&x);
   return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,180 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <sched.h>
+#include "spin.h"
+#include "team.h"
+
+// A parallel loop in progress.
+typedef struct {
+  team_t * team;
+  long first;
+  long last;
+  long chunk;
+  team_schedule_t schedule;
+  team_body_t body;
+  void * arg;
+} team_loop_t;
+
+// Main loop of a member: wait for a new work, run it, report its
+// completion.
+static void * team_main(void * arg) {
+  team_member_t * m = arg;
+  team_t * t = m->team;
+  long generation = 0;
+
+  pthread_mutex_lock(&t->mutex);
+  for (;;) {
+    while (!t->shutdown && t->generation == generation)
+      pthread_cond_wait(&t->start, &t->mutex);
+    if (t->shutdown) break;
+    generation = t->generation;
+    pthread_mutex_unlock(&t->mutex);
+
+    t->func(t->arg, m->id);
+
+    pthread_mutex_lock(&t->mutex);
+    if (--t->n_running == 0)
+      pthread_cond_signal(&t->done);
+  }
+  pthread_mutex_unlock(&t->mutex);
+  return NULL;
+}
+
+team_t * team_init(int n_threads, const int * cpus) {
+  team_t * t = aligned_alloc(64, sizeof(team_t));
+  pthread_attr_t attr;
+#ifdef __linux__
+  cpu_set_t set;
+#endif
+
+  t->n_threads = n_threads;
+  t->members = aligned_alloc(64, n_threads * sizeof(team_member_t));
+  pthread_mutex_init(&t->mutex, NULL);
+  pthread_cond_init(&t->start, NULL);
+  pthread_cond_init(&t->done, NULL);
+  t->generation = 0;
+  t->n_running = 0;
+  t->shutdown = 0;
+  atomic_init(&t->waiting, n_threads);
+  atomic_init(&t->sense, 0);
+  atomic_init(&t->next, 0);
+
+  pthread_attr_init(&attr);
+  for (int i = 0; i < n_threads; i++) {
+    team_member_t * m = &t->members[i];
+    m->team = t;
+    m->id = i;
+    m->sense = 0;
+#ifdef __linux__
+    if (cpus != NULL) {
+      CPU_ZERO(&set);
+      CPU_SET(cpus[i], &set);
+      pthread_attr_setaffinity_np(&attr, sizeof(set), &set);
+    }
+#endif
+    if (pthread_create(&m->thread, &attr, team_main, m) != 0) {
+      printf("cannot create member %d\n", i);
+      exit(1);
+    }
+  }
+  pthread_attr_destroy(&attr);
+  return t;
+}
+
+void team_cpus(int n, int * cpus) {
+#ifdef __linux__
+  cpu_set_t allowed;
+  int cpu = 0;
+
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0 ||
+      CPU_COUNT(&allowed) == 0) {
+    CPU_ZERO(&allowed);
+    CPU_SET(0, &allowed);
+  }
+  for (int i = 0; i < n; i++) {
+    while (!CPU_ISSET(cpu, &allowed)) cpu = (cpu + 1) % CPU_SETSIZE;
+    cpus[i] = cpu;
+    cpu = (cpu + 1) % CPU_SETSIZE;
+  }
+#else
+  for (int i = 0; i < n; i++)
+    cpus[i] = i;
+#endif
+}
+
+void team_run(team_t * t, team_func_t func, void * arg) {
+  pthread_mutex_lock(&t->mutex);
+  t->func = func;
+  t->arg = arg;
+  t->n_running = t->n_threads;
+  t->generation++;
+  pthread_cond_broadcast(&t->start);
+  while (t->n_running > 0)
+    pthread_cond_wait(&t->done, &t->mutex);
+  pthread_mutex_unlock(&t->mutex);
+}
+
+void team_barrier(team_t * t, int id) {
+  int * sense = &t->members[id].sense;
+  int spins = 0;
+
+  *sense = !*sense;
+  if (atomic_fetch_sub_explicit(&t->waiting, 1, memory_order_acq_rel) == 1) {
+    atomic_store_explicit(&t->waiting, t->n_threads, memory_order_relaxed);
+    atomic_store_explicit(&t->sense, *sense, memory_order_release);
+    return;
+  }
+  while (atomic_load_explicit(&t->sense, memory_order_acquire) != *sense)
+    spin_wait(&spins);
+}
+
+// The part of a parallel loop run by member id.
+static void team_loop(void * arg, int id) {
+  team_loop_t * l = arg;
+  team_t * t = l->team;
+  long n = l->last - l->first, first, last;
+
+  if (l->schedule == TEAM_DYNAMIC) {
+    long chunk = (l->chunk > 0) ? l->chunk : 1;
+    while ((first = atomic_fetch_add_explicit(&t->next, chunk,
+                                              memory_order_relaxed))
+           < l->last) {
+      last = (l->last - first < chunk) ? l->last : first + chunk;
+      l->body(l->arg, first, last, id);
+    }
+  } else if (l->chunk <= 0) {
+    first = l->first + n * id / t->n_threads;
+    last = l->first + n * (id + 1) / t->n_threads;
+    if (first < last) l->body(l->arg, first, last, id);
+  } else {
+    for (first = l->first + id * l->chunk; first < l->last;
+         first += t->n_threads * l->chunk) {
+      last = (l->last - first < l->chunk) ? l->last : first + l->chunk;
+      l->body(l->arg, first, last, id);
+    }
+  }
+}
+
+void team_parallel_for(team_t * t, long first, long last, long chunk,
+                       team_schedule_t schedule, team_body_t body,
+                       void * arg) {
+  team_loop_t l = {t, first, last, chunk, schedule, body, arg};
+  atomic_store(&t->next, first);
+  team_run(t, team_loop, &l);
+}
+
+void team_destroy(team_t * t) {
+  pthread_mutex_lock(&t->mutex);
+  t->shutdown = 1;
+  pthread_cond_broadcast(&t->start);
+  pthread_mutex_unlock(&t->mutex);
+
+  for (int i = 0; i < t->n_threads; i++)
+    pthread_join(t->members[i].thread, NULL);
+  pthread_mutex_destroy(&t->mutex);
+  pthread_cond_destroy(&t->start);
+  pthread_cond_destroy(&t->done);
+  free(t->members);
+  free(t);
+}
@@ -0,0 +1,80 @@
+#ifndef TEAM_H
+#define TEAM_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+
+// Work run by every member of a team, id going from 0 to
+// n_threads - 1.
+typedef void (*team_func_t)(void * arg, int id);
+
+// Body of a parallel loop: run iterations [first, last) as member id.
+typedef void (*team_body_t)(void * arg, long first, long last, int id);
+
+// How the iterations of a parallel loop are shared by the members.
+typedef enum {
+  // Contiguous parts of equal size, or chunks dealt round-robin.
+  TEAM_STATIC,
+  // Chunks claimed from a shared counter as members become free.
+  TEAM_DYNAMIC
+} team_schedule_t;
+
+struct team_t;
+
+// A member of a team, alone on its cache line.
+typedef struct {
+  struct team_t * team;
+  int id;
+  int sense;                            // of the barrier
+  pthread_t thread;
+} __attribute__((aligned(64))) team_member_t;
+
+// A set of threads created once, optionally pinned to processors, and
+// reused by each call to team_run, so that measures do not include
+// thread creation. The caller waits while the members work.
+typedef struct team_t {
+  int n_threads;
+  team_member_t * members;
+  pthread_mutex_t mutex;
+  pthread_cond_t start;                 // a new work is posted
+  pthread_cond_t done;                  // the last member is done
+  long generation;                      // works posted so far
+  int n_running;                        // members still running the work
+  int shutdown;
+  team_func_t func;
+  void * arg;
+  // sense-reversing barrier: the last member to arrive resets the
+  // count and flips the sense the others spin on
+  _Alignas(64) atomic_int waiting;
+  _Alignas(64) atomic_int sense;
+  // next iteration of a dynamic loop
+  _Alignas(64) atomic_long next;
+} team_t;
+
+// Create a team of n_threads threads, thread i being pinned to
+// processor cpus[i], or not pinned if cpus is NULL (or on systems
+// without processor affinity).
+team_t * team_init(int n_threads, const int * cpus);
+
+// Fill cpus[0..n-1] with the processors the process may run on, in
+// turn.
+void team_cpus(int n, int * cpus);
+
+// Run func(arg, id) on every member of t and wait until all of them
+// have returned.
+void team_run(team_t * t, team_func_t func, void * arg);
+
+// Wait until all the members of t reach the barrier. Called by member
+// id within team_run.
+void team_barrier(team_t * t, int id);
+
+// Run body over iterations [first, last) on the members of t, chunk
+// iterations at a time (for TEAM_STATIC, chunk <= 0 gives each member
+// one contiguous part), and wait until all of them are done.
+void team_parallel_for(team_t * t, long first, long last, long chunk,
+                       team_schedule_t schedule, team_body_t body,
+                       void * arg);
+
+// Stop the threads of t and free it.
+void team_destroy(team_t * t);
+#endif
@@ -0,0 +1,109 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include "topology.h"
+
+char * placement_names[] = {"any", "smt", "socket", "cross"};
+
+// A processor, its position in the machine, and its sort key.
+typedef struct {
+  int cpu;
+  int package;
+  int core;
+  int thread;                           // rank among the SMT siblings
+  int core_rank;                        // rank among the package cores
+  int key[3];
+} cpu_t;
+
+placement_t placement_parse(char * name) {
+  placement_t p;
+  for (p = 0; p < N_PLACEMENTS; p++)
+    if (strcmp(name, placement_names[p]) == 0) break;
+  return p;
+}
+
+// Return the integer in the topology file of cpu, or otherwise if it
+// cannot be read.
+static int read_topology(int cpu, char * file, int otherwise) {
+  char path[128];
+  int value;
+  snprintf(path, sizeof(path),
+           "/sys/devices/system/cpu/cpu%d/topology/%s", cpu, file);
+  FILE * f = fopen(path, "r");
+  if (f == NULL) return otherwise;
+  if (fscanf(f, "%d", &value) != 1) value = otherwise;
+  fclose(f);
+  return value;
+}
+
+static int compare_keys(const void * a, const void * b) {
+  const cpu_t * x = a, * y = b;
+  for (int i = 0; i < 3; i++)
+    if (x->key[i] != y->key[i]) return x->key[i] - y->key[i];
+  return x->cpu - y->cpu;
+}
+
+int placement_cpus(placement_t p, int n, int * cpus) {
+  cpu_set_t allowed;
+  int n_cpus = 0, ok;
+
+  if (p == PLACE_ANY || sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+    return 0;
+  cpu_t * c = malloc(CPU_COUNT(&allowed) * sizeof(cpu_t));
+  for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+    if (!CPU_ISSET(cpu, &allowed)) continue;
+    c[n_cpus].cpu = cpu;
+    c[n_cpus].package = read_topology(cpu, "physical_package_id", 0);
+    c[n_cpus].core = read_topology(cpu, "core_id", cpu);
+    n_cpus++;
+  }
+
+  // rank of each processor among its siblings, of each core in its
+  // package (processors are in increasing order)
+  for (int i = 0; i < n_cpus; i++) {
+    c[i].thread = 0;
+    for (int j = 0; j < i; j++)
+      if (c[j].package == c[i].package && c[j].core == c[i].core)
+        c[i].thread++;
+  }
+  for (int i = 0; i < n_cpus; i++) {
+    c[i].core_rank = 0;
+    for (int j = 0; j < n_cpus; j++)
+      if (c[j].package == c[i].package && c[j].core < c[i].core &&
+          c[j].thread == 0)
+        c[i].core_rank++;
+  }
+
+  // order the processors so that consecutive ones are placed as
+  // requested: siblings first, or cores of a package first, or
+  // packages in turn
+  for (int i = 0; i < n_cpus; i++) {
+    int * k = c[i].key;
+    switch (p) {
+    case PLACE_SMT:
+      k[0] = c[i].package; k[1] = c[i].core; k[2] = c[i].thread;
+      break;
+    case PLACE_SOCKET:
+      k[0] = c[i].package; k[1] = c[i].thread; k[2] = c[i].core;
+      break;
+    default:
+      k[0] = c[i].thread; k[1] = c[i].core_rank; k[2] = c[i].package;
+      break;
+    }
+  }
+  qsort(c, n_cpus, sizeof(cpu_t), compare_keys);
+
+  ok = (n_cpus >= 2);
+  if (ok) {
+    int same_package = (c[0].package == c[1].package);
+    int same_core = same_package && (c[0].core == c[1].core);
+    ok = (p == PLACE_SMT) ? same_core :
+         (p == PLACE_SOCKET) ? same_package && !same_core : !same_package;
+  }
+  for (int i = 0; ok && i < n; i++)
+    cpus[i] = c[i % n_cpus].cpu;
+  free(c);
+  return ok;
+}
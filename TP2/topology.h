@@ -0,0 +1,32 @@
+#ifndef TOPOLOGY_H
+#define TOPOLOGY_H
+
+// Where consecutive threads are pinned relative to each other.
+typedef enum {
+  // Not pinned: the scheduler places the threads.
+  PLACE_ANY,
+  // Hardware threads (SMT siblings) of the same core, sharing its L1
+  // and L2 caches.
+  PLACE_SMT,
+  // Different cores of the same socket, sharing its last level cache.
+  PLACE_SOCKET,
+  // Cores of different sockets, a store to a line cached by the other
+  // one crossing the interconnect.
+  PLACE_CROSS,
+  N_PLACEMENTS
+} placement_t;
+
+// Names of the placements, indexed by placement_t.
+extern char * placement_names[];
+
+// Return the placement of the given name, N_PLACEMENTS if unknown.
+placement_t placement_parse(char * name);
+
+// Fill cpus[0..n-1] with the processors to pin n threads to, so that
+// threads 0 and 1 (and, as far as possible, each pair of consecutive
+// threads) are placed as p requests. The processors are the ones the
+// process may run on, their topology being read from sysfs.
+// Return 1 on success, 0 if p is PLACE_ANY or if no pair of
+// processors is placed as p requests.
+int placement_cpus(placement_t p, int n, int * cpus);
+#endif
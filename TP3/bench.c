@@ -0,0 +1,115 @@
+#include <stdio.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <time.h>
+
+#include "bench.h"
+
+// Return the current value of the monotonic clock in nanoseconds.
+long bench_now_ns() {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000000000L + ts.tv_nsec;
+}
+
+// Return the CPU time (user and system) consumed by the process so
+// far, in seconds.
+void bench_cpu_time(double * user, double * sys) {
+  struct rusage ru;
+
+  getrusage(RUSAGE_SELF, &ru);
+  *user = ru.ru_utime.tv_sec + ru.ru_utime.tv_usec / 1E6;
+  *sys  = ru.ru_stime.tv_sec + ru.ru_stime.tv_usec / 1E6;
+}
+
+// Bucket of a latency. Values below LATENCY_SUB_BUCKETS get their own
+// bucket, larger ones share a bucket with the values having the same
+// LATENCY_SUB_BITS most significant bits.
+static int latency_bucket(long ns) {
+  int msb;
+
+  if (ns < LATENCY_SUB_BUCKETS) return (ns < 0) ? 0 : ns;
+  msb = 63 - __builtin_clzl(ns);
+  return (msb - LATENCY_SUB_BITS + 1) * LATENCY_SUB_BUCKETS
+    + (int)(ns >> (msb - LATENCY_SUB_BITS)) - LATENCY_SUB_BUCKETS;
+}
+
+// Largest latency stored in bucket i.
+static long latency_bucket_upper(int i) {
+  int group = i / LATENCY_SUB_BUCKETS;
+  int sub   = i % LATENCY_SUB_BUCKETS;
+
+  if (group == 0) return sub;
+  return ((long)(LATENCY_SUB_BUCKETS + sub + 1) << (group - 1)) - 1;
+}
+
+void latency_histogram_init(latency_histogram_t * h) {
+  memset(h, 0, sizeof(*h));
+}
+
+void latency_histogram_add(latency_histogram_t * h, long ns) {
+  h->buckets[latency_bucket(ns)]++;
+  h->count++;
+  h->sum += ns;
+  if (h->max < ns) h->max = ns;
+}
+
+void latency_histogram_merge(latency_histogram_t * into,
+                             latency_histogram_t * from) {
+  int i;
+
+  for (i = 0; i < LATENCY_BUCKETS; i++)
+    into->buckets[i] += from->buckets[i];
+  into->count += from->count;
+  into->sum   += from->sum;
+  if (into->max < from->max) into->max = from->max;
+}
+
+long latency_histogram_percentile(latency_histogram_t * h, double q) {
+  long rank = (long)(q * h->count + 0.5);
+  long seen = 0;
+  long upper;
+  int  i;
+
+  if (rank < 1) rank = 1;
+  for (i = 0; i < LATENCY_BUCKETS; i++) {
+    seen += h->buckets[i];
+    if (rank <= seen) {
+      upper = latency_bucket_upper(i);
+      return (upper < h->max) ? upper : h->max;
+    }
+  }
+  return h->max;
+}
+
+void latency_histogram_print(char * label, latency_histogram_t * h) {
+  if (h->count == 0) {
+    printf("%s: no sample\n", label);
+    return;
+  }
+  printf("%s: n=%ld mean=%ld p50=%ld p90=%ld p99=%ld p99.9=%ld max=%ld (ns)\n",
+         label,
+         h->count,
+         h->sum / h->count,
+         latency_histogram_percentile(h, 0.50),
+         latency_histogram_percentile(h, 0.90),
+         latency_histogram_percentile(h, 0.99),
+         latency_histogram_percentile(h, 0.999),
+         h->max);
+}
+
+void latency_histogram_csv_header(char * prefix) {
+  printf(",%s_mean_ns,%s_p50_ns,%s_p90_ns,%s_p99_ns,%s_p999_ns,%s_max_ns",
+         prefix, prefix, prefix, prefix, prefix, prefix);
+}
+
+void latency_histogram_csv(latency_histogram_t * h) {
+  printf(",%ld,%ld,%ld,%ld,%ld,%ld",
+         (h->count) ? h->sum / h->count : 0,
+         latency_histogram_percentile(h, 0.50),
+         latency_histogram_percentile(h, 0.90),
+         latency_histogram_percentile(h, 0.99),
+         latency_histogram_percentile(h, 0.999),
+         h->max);
+}
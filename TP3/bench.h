@@ -0,0 +1,53 @@
+#ifndef BENCH_H
+#define BENCH_H
+#include <time.h>
+
+// Latencies are recorded in a log-linear histogram: one group of
+// LATENCY_SUB_BUCKETS buckets per power of two, which bounds the
+// relative error of a percentile to 1/LATENCY_SUB_BUCKETS without
+// storing any individual sample.
+#define LATENCY_SUB_BITS    4
+#define LATENCY_SUB_BUCKETS (1 << LATENCY_SUB_BITS)
+#define LATENCY_GROUPS      (64 - LATENCY_SUB_BITS)
+#define LATENCY_BUCKETS     (LATENCY_GROUPS * LATENCY_SUB_BUCKETS)
+
+typedef struct {
+  long count;
+  long sum;   // nanoseconds
+  long max;   // nanoseconds
+  long buckets[LATENCY_BUCKETS];
+} latency_histogram_t;
+
+// Return the current value of the monotonic clock in nanoseconds.
+long bench_now_ns();
+
+// Return the CPU time (user and system) consumed by the process so
+// far, in seconds.
+void bench_cpu_time(double * user, double * sys);
+
+// Reset histogram h.
+void latency_histogram_init(latency_histogram_t * h);
+
+// Record a latency of ns nanoseconds in histogram h.
+void latency_histogram_add(latency_histogram_t * h, long ns);
+
+// Add all the samples of histogram from into histogram into.
+void latency_histogram_merge(latency_histogram_t * into,
+                             latency_histogram_t * from);
+
+// Return the latency (ns) below which a fraction q (0 < q <= 1) of
+// the samples of histogram h lie.
+long latency_histogram_percentile(latency_histogram_t * h, double q);
+
+// Print count, mean and usual percentiles of histogram h on a single
+// line prefixed by label.
+void latency_histogram_print(char * label, latency_histogram_t * h);
+
+// Print the CSV column names of latency_histogram_csv, each of them
+// prefixed by prefix. Every column is preceded by a comma.
+void latency_histogram_csv_header(char * prefix);
+
+// Print mean and usual percentiles (ns) of histogram h as CSV
+// columns. Every column is preceded by a comma.
+void latency_histogram_csv(latency_histogram_t * h);
+#endif
@@ -38,4 +38,9 @@ int circular_buffer_put(circular_buffer_t * b, void * d){
 int circular_buffer_size(circular_buffer_t * b) {
   return b->size;
 }
+
+void circular_buffer_destroy(circular_buffer_t * b) {
+  free(b->buffer);
+  free(b);
+}
    
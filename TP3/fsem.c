@@ -0,0 +1,138 @@
+#include <errno.h>
+#include "fsem.h"
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Sleep while *addr is val, at most until the absolute CLOCK_REALTIME
+// time abstime unless it is NULL. Return -1 with errno ETIMEDOUT on
+// timeout, otherwise 0 (the caller checks the value again).
+static int futex_wait(atomic_int * addr, int val,
+                      const struct timespec * abstime) {
+  long rc = syscall(SYS_futex, addr,
+                    FUTEX_WAIT_BITSET | FUTEX_PRIVATE_FLAG |
+                    FUTEX_CLOCK_REALTIME,
+                    val, abstime, NULL, FUTEX_BITSET_MATCH_ANY);
+  if ((rc == -1) && (errno == ETIMEDOUT)) return -1;
+  return 0;
+}
+
+// Wake up to n threads sleeping on addr.
+static void futex_wake(atomic_int * addr, int n) {
+  syscall(SYS_futex, addr, FUTEX_WAKE | FUTEX_PRIVATE_FLAG, n,
+          NULL, NULL, 0);
+}
+
+int fsem_init(fsem_t * s, unsigned int value) {
+  atomic_init(&s->value, value);
+  atomic_init(&s->waiters, 0);
+  return 0;
+}
+
+int fsem_destroy(fsem_t * s) {
+  return 0;
+}
+
+int fsem_trywait(fsem_t * s) {
+  int v = atomic_load(&s->value);
+
+  while (v > 0)
+    if (atomic_compare_exchange_weak(&s->value, &v, v - 1))
+      return 0;
+  errno = EAGAIN;
+  return -1;
+}
+
+int fsem_timedwait(fsem_t * s, const struct timespec * abstime) {
+  while (fsem_trywait(s) != 0) {
+    // Announce the sleep before checking the count in the kernel: a
+    // post either sees the waiter, or happens before the check and
+    // makes futex_wait return at once.
+    atomic_fetch_add(&s->waiters, 1);
+    int rc = futex_wait(&s->value, 0, abstime);
+    atomic_fetch_sub(&s->waiters, 1);
+    if (rc != 0) {
+      // A post may have come along with the timeout
+      if (fsem_trywait(s) == 0) return 0;
+      errno = ETIMEDOUT;
+      return -1;
+    }
+  }
+  return 0;
+}
+
+int fsem_wait(fsem_t * s) {
+  return fsem_timedwait(s, NULL);
+}
+
+int fsem_post(fsem_t * s) {
+  atomic_fetch_add(&s->value, 1);
+  if (atomic_load(&s->waiters) > 0)
+    futex_wake(&s->value, 1);
+  return 0;
+}
+
+#else
+
+int fsem_init(fsem_t * s, unsigned int value) {
+  s->value = value;
+  pthread_mutex_init(&s->mutex, NULL);
+  pthread_cond_init(&s->positive, NULL);
+  return 0;
+}
+
+int fsem_destroy(fsem_t * s) {
+  pthread_mutex_destroy(&s->mutex);
+  pthread_cond_destroy(&s->positive);
+  return 0;
+}
+
+int fsem_trywait(fsem_t * s) {
+  int rc = -1;
+
+  pthread_mutex_lock(&s->mutex);
+  if (s->value > 0) {
+    s->value--;
+    rc = 0;
+  }
+  pthread_mutex_unlock(&s->mutex);
+  if (rc != 0) errno = EAGAIN;
+  return rc;
+}
+
+int fsem_timedwait(fsem_t * s, const struct timespec * abstime) {
+  int rc = 0;
+
+  pthread_mutex_lock(&s->mutex);
+  while ((s->value == 0) && (rc != ETIMEDOUT)) {
+    if (abstime == NULL)
+      pthread_cond_wait(&s->positive, &s->mutex);
+    else
+      rc = pthread_cond_timedwait(&s->positive, &s->mutex, abstime);
+  }
+  if (s->value > 0) {
+    s->value--;
+    rc = 0;
+  }
+  pthread_mutex_unlock(&s->mutex);
+  if (rc != 0) {
+    errno = ETIMEDOUT;
+    return -1;
+  }
+  return 0;
+}
+
+int fsem_wait(fsem_t * s) {
+  return fsem_timedwait(s, NULL);
+}
+
+int fsem_post(fsem_t * s) {
+  pthread_mutex_lock(&s->mutex);
+  s->value++;
+  pthread_cond_signal(&s->positive);
+  pthread_mutex_unlock(&s->mutex);
+  return 0;
+}
+#endif
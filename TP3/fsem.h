@@ -0,0 +1,43 @@
+#ifndef FSEM_H
+#define FSEM_H
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
+
+// Counting semaphore with the interface of sem_t. On Linux, the count
+// is an atomic integer and a thread only enters the kernel (futex) to
+// sleep on a zero count, or to wake a sleeping thread: wait and post
+// take one atomic operation each when the count allows it. Elsewhere
+// it falls back on a mutex and a condition variable.
+typedef struct {
+#ifdef __linux__
+  atomic_int value;
+  atomic_int waiters;   // Threads sleeping (or about to) on value
+#else
+  int             value;
+  pthread_mutex_t mutex;
+  pthread_cond_t  positive;
+#endif
+} fsem_t;
+
+// Initialise s with count value. Return 0.
+int fsem_init(fsem_t * s, unsigned int value);
+
+// Destroy s. Return 0.
+int fsem_destroy(fsem_t * s);
+
+// Decrement s, sleeping until its count is positive. Return 0.
+int fsem_wait(fsem_t * s);
+
+// Decrement s if its count is positive and return 0. Otherwise,
+// return -1 and set errno to EAGAIN.
+int fsem_trywait(fsem_t * s);
+
+// Decrement s, sleeping until its count is positive but no longer
+// than the absolute CLOCK_REALTIME time abstime. Return 0 if s was
+// decremented. Otherwise, return -1 and set errno to ETIMEDOUT.
+int fsem_timedwait(fsem_t * s, const struct timespec * abstime);
+
+// Increment s, waking a sleeping thread if any. Return 0.
+int fsem_post(fsem_t * s);
+#endif
@@ -1,16 +1,46 @@
 #include <pthread.h>
+#include <stdatomic.h>
+#include <sched.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/time.h>
 #include <unistd.h>
 
+#include "bench.h"
+#include "parser.h"
 #include "protected_buffer.h"
 #include "sem_protected_buffer.h"
+#include "team.h"
 #include "utils.h"
 
 protected_buffer_t * protected_buffer;
-pthread_t * tasks;
+
+// Producers and consumers, created once and reused by every run: the
+// first n_consumers members are consumers, the others producers.
+team_t * team;
+
+// Benchmark mode. When both consumer_period and producer_period are
+// 0, producers and consumers no longer behave as periodic tasks: they
+// transfer n_values items as fast as possible and the program reports
+// throughput, latency percentiles and CPU time.
+typedef struct {
+  int                 id;
+  long                n_items;  // Number of items to produce
+  long                n_done;   // Number of items put or got
+  long                n_failed; // Number of failed or timed out attempts
+  latency_histogram_t latency;  // Latency of successful operations
+} bench_task_t;
+
+#define BENCH_TIMEOUT 1  // Timeout (millis) of poll / offer operations
+
+long bench_duration = 0; // Stop producing after bench_duration ms (0: never)
+long csv_output = 0;     // Report benchmark results as CSV
+long bench_stop_ns;      // Monotonic time at which producers stop
+int  bench_item;         // Payload of every item transferred
+int  bench_stop_token;   // Sent to each consumer once producers are done
+
+atomic_long     bench_producers; // Producers still running
 
 // Main consumer. Get consumer id as argument.
 void * main_consumer(void * arg){
@@ -46,7 +76,6 @@ void * main_consumer(void * arg){
     if (data != NULL) free(data);
     delay_until (&deadline);
   }
-  pthread_exit (NULL);
   return NULL;
 }
 
@@ -97,84 +126,324 @@ void * main_producer(void * arg){
     if (!done) data = NULL;
     delay_until (&deadline);
   }
-  pthread_exit (NULL);
   return NULL;
 }
 
-// Read scenario file
-void read_file(char * filename);
+// Compute the absolute deadline of a poll / offer operation.
+void bench_timeout(struct timespec * deadline){
+  struct timeval tv_now;
 
-int main(int argc, char *argv[]){
-  int   i;
-  int * data;
+  gettimeofday(&tv_now, NULL);
+  TIMEVAL_TO_TIMESPEC(&tv_now, deadline);
+  add_millis_to_timespec(deadline, BENCH_TIMEOUT);
+}
+
+// Benchmark consumer. Get items until the stop token is received.
+void * bench_consumer(void * arg){
+  bench_task_t  * task = (bench_task_t *) arg;
+  struct timespec deadline;
+  void          * data = NULL;
+  long            t0, t1;
 
-  if (argc != 2) {
-    printf("Usage : %s <scenario file>\n", argv[0]);
-    exit(1);
+  while (1) {
+    if (semantics == TIMEDOUT) bench_timeout(&deadline);
+    t0 = bench_now_ns();
+    switch (semantics) {
+    case BLOCKING:
+      data = protected_buffer_get(protected_buffer);
+      break;
+    case NONBLOCKING:
+      data = protected_buffer_remove(protected_buffer);
+      break;
+    case TIMEDOUT:
+      data = protected_buffer_poll(protected_buffer, &deadline);
+      break;
+    default:;
+    }
+    t1 = bench_now_ns();
+    if (data == NULL) {
+      // Let a producer run rather than spinning on an empty buffer
+      task->n_failed++;
+      sched_yield();
+      continue;
+    }
+    if (data == &bench_stop_token) break;
+    latency_histogram_add(&task->latency, t1 - t0);
+    task->n_done++;
   }
+  return NULL;
+}
 
-  init_utils();
-  read_file(argv[1]);
+// Send the stop token to each consumer.
+void bench_stop_consumers(){
+  int i;
 
-  protected_buffer = protected_buffer_init(sem_impl, buffer_size);
+  for (i = 0; i < n_consumers; i++)
+    protected_buffer_put(protected_buffer, &bench_stop_token);
+}
 
+// Benchmark producer. Put n_items items, retrying failed attempts,
+// unless the benchmark duration has elapsed. The last producer to
+// finish sends the stop token to each consumer.
+void * bench_producer(void * arg){
+  bench_task_t  * task = (bench_task_t *) arg;
+  struct timespec deadline;
+  long            i, t0, t1;
+  long            done = 0;
+
+  for (i = 0; i < task->n_items; i++) {
+    do {
+      if (semantics == TIMEDOUT) bench_timeout(&deadline);
+      t0 = bench_now_ns();
+      switch (semantics) {
+      case BLOCKING:
+        protected_buffer_put(protected_buffer, &bench_item);
+        done = 1;
+        break;
+      case NONBLOCKING:
+        done = protected_buffer_add(protected_buffer, &bench_item);
+        break;
+      case TIMEDOUT:
+        done = protected_buffer_offer(protected_buffer, &bench_item, &deadline);
+        break;
+      default:;
+      }
+      t1 = bench_now_ns();
+      if (!done) {
+        task->n_failed++;
+        sched_yield();
+      }
+    } while (!done);
+    latency_histogram_add(&task->latency, t1 - t0);
+    task->n_done++;
+    if (bench_stop_ns && (bench_stop_ns <= t1)) break;
+  }
+  if (atomic_fetch_sub(&bench_producers, 1) == 1)
+    bench_stop_consumers();
+  return NULL;
+}
 
-  set_start_time();
+// Run member id of the team as a benchmark consumer or producer.
+// Without producers, the first consumer stops them all.
+void bench_member(void * arg, int id){
+  bench_task_t * bench_tasks = (bench_task_t *) arg;
+
+  if ((id == 0) && (n_producers == 0))
+    bench_stop_consumers();
+  if (id < n_consumers)
+    bench_consumer(bench_tasks + id);
+  else
+    bench_producer(bench_tasks + id);
+}
+
+// Print the CSV header of the rows of run_benchmark.
+void print_csv_header(){
+  printf("impl,semantics,buffer_size,n_values,n_producers,n_consumers,"
+         "duration_ms,items,elapsed_s,items_per_s,ops_per_s,"
+         "cpu_user_s,cpu_sys_s,put_failed,get_failed");
+  latency_histogram_csv_header("put");
+  latency_histogram_csv_header("get");
+  printf("\n");
+}
+
+// Run the scenario in benchmark mode using implementation impl. In
+// CSV mode, print a single row.
+void run_benchmark(long impl){
+  bench_task_t      * bench_tasks;
+  latency_histogram_t put_latency, get_latency;
+  long                n_put = 0, n_get = 0, put_failed = 0, get_failed = 0;
+  long                t0, t1;
+  double              user0, sys0, user1, sys1, elapsed;
+  char              * name = protected_buffer_impl_name(impl);
+  char                label[64];
+  int                 i;
+
+  protected_buffer = protected_buffer_init(impl, buffer_size);
+
+  bench_tasks = malloc(sizeof *bench_tasks * (n_consumers + n_producers));
+  for (i = 0; i < n_consumers + n_producers; i++) {
+    bench_tasks[i].id       = i;
+    bench_tasks[i].n_items  = 0;
+    bench_tasks[i].n_done   = 0;
+    bench_tasks[i].n_failed = 0;
+    latency_histogram_init(&bench_tasks[i].latency);
+  }
 
-  // Create consumers and then producers. Pass the *value* of i
-  // as parametre of the main procedure s(main_consumer or main_producer).
-  tasks=malloc(sizeof *tasks*(n_consumers+n_producers));
-  for (i=0; i<n_consumers; i++) {
-    data = malloc(sizeof(int));
-    *data = i;
-    pthread_create(tasks+i,NULL,main_consumer,data);
+  // Split n_values among producers. The first producers get one more
+  // item when n_values is not a multiple of n_producers.
+  for (i = 0; i < n_producers; i++)
+    bench_tasks[n_consumers + i].n_items =
+      n_values / n_producers + (i < n_values % n_producers);
+
+  // Start all the tasks at once on the threads of the team, and wait
+  // until the consumers got the stop tokens of the last producer
+  bench_cpu_time(&user0, &sys0);
+  t0 = bench_now_ns();
+  bench_stop_ns = (bench_duration) ? t0 + bench_duration * 1000000L : 0;
+  atomic_store(&bench_producers, n_producers);
+  team_run(team, bench_member, bench_tasks);
+
+  t1 = bench_now_ns();
+  bench_cpu_time(&user1, &sys1);
+  elapsed = (t1 - t0) / 1E9;
+
+  latency_histogram_init(&put_latency);
+  latency_histogram_init(&get_latency);
+  for (i = 0; i < n_consumers; i++) {
+    latency_histogram_merge(&get_latency, &bench_tasks[i].latency);
+    n_get      += bench_tasks[i].n_done;
+    get_failed += bench_tasks[i].n_failed;
   }
-  for (i=n_consumers; i<n_producers+n_consumers; i++) {
-    data = malloc(sizeof(int));
-    *data = i;
-    pthread_create(tasks+i,NULL,main_producer,data);
+  for (i = n_consumers; i < n_producers+n_consumers; i++) {
+    latency_histogram_merge(&put_latency, &bench_tasks[i].latency);
+    n_put      += bench_tasks[i].n_done;
+    put_failed += bench_tasks[i].n_failed;
   }
 
-  // Wait for producers and consumers termination
-  for (i=0; i<n_consumers+n_producers; i++) {
-    pthread_join(*(tasks+i),NULL);
+  if (csv_output) {
+    printf("%s,%ld,%ld,%ld,%ld,%ld,%ld,%ld,%.6f,%.0f,%.0f,%.3f,%.3f,%ld,%ld",
+           name, semantics, buffer_size, n_values, n_producers, n_consumers,
+           bench_duration, n_get, elapsed, n_get / elapsed,
+           (n_put + n_get) / elapsed, user1 - user0, sys1 - sys0,
+           put_failed, get_failed);
+    latency_histogram_csv(&put_latency);
+    latency_histogram_csv(&get_latency);
+    printf("\n");
+  } else {
+    printf("%s: %ld items in %.6f s, %.0f items/s, %.0f ops/s\n",
+           name, n_get, elapsed, n_get / elapsed, (n_put + n_get) / elapsed);
+    printf("%s: cpu user %.3f s, sys %.3f s, %.2f cpus\n",
+           name, user1 - user0, sys1 - sys0,
+           ((user1 - user0) + (sys1 - sys0)) / elapsed);
+    printf("%s: failed attempts put %ld, get %ld\n", name, put_failed, get_failed);
+    snprintf(label, sizeof(label), "%s put", name);
+    latency_histogram_print(label, &put_latency);
+    snprintf(label, sizeof(label), "%s get", name);
+    latency_histogram_print(label, &get_latency);
+    if (n_put != n_get)
+      printf("%s: %ld items put but %ld items got\n", name, n_put, n_get);
   }
+
+  free(bench_tasks);
+  protected_buffer_destroy(protected_buffer);
 }
 
-void read_file(char * filename){
-  FILE * file;
+// Run member id of the team as the main consumer or producer id.
+void main_member(void * arg, int id){
+  int * ids = (int *) arg;
+
+  if (id < n_consumers)
+    main_consumer(ids + id);
+  else
+    main_producer(ids + id);
+}
+
+// Read scenario file
+void read_file(char * filename);
 
-  file = fopen (filename, "r");
+void usage(char * name){
+  printf("Usage : %s <scenario file> [-t millis] [-i impl|all] [-c]\n", name);
+  printf("  -t millis : in benchmark mode, stop producing after millis ms\n");
+  printf("  -i impl   : override sem_impl (number or name), or benchmark\n");
+  printf("              every implementation\n");
+  printf("  -c        : in benchmark mode, report results as CSV\n");
+  exit(1);
+}
 
-  get_string (file, "#sem_impl", __FILE__, __LINE__);
-  get_long   (file, (long *) &sem_impl, __FILE__, __LINE__);
-  printf ("sem_impl = %ld\n", sem_impl);
+int main(int argc, char *argv[]){
+  int   i;
+  int * ids;
+  int * cpus;
+  long  impl = -1;
+  int   all_impls = 0;
+
+  if (argc < 2) usage(argv[0]);
+  for (i = 2; i < argc; i++) {
+    if ((strcmp(argv[i], "-t") == 0) && (i + 1 < argc))
+      bench_duration = strtol(argv[++i], NULL, 10);
+    else if ((strcmp(argv[i], "-i") == 0) && (i + 1 < argc)) {
+      i++;
+      if (strcmp(argv[i], "all") == 0)
+        all_impls = 1;
+      else if (('0' <= argv[i][0]) && (argv[i][0] <= '9'))
+        impl = strtol(argv[i], NULL, 10);
+      else if ((impl = protected_buffer_find(argv[i])) < 0)
+        usage(argv[0]);
+    } else if (strcmp(argv[i], "-c") == 0)
+      csv_output = 1;
+    else
+      usage(argv[0]);
+  }
 
-  get_string (file, "#semantics", __FILE__, __LINE__);
-  get_long   (file, (long *) &semantics, __FILE__, __LINE__);
-  printf ("semantics = %ld\n", semantics);
+  init_utils();
+  read_file(argv[1]);
+  if (0 <= impl) sem_impl = impl;
+
+  // Run every selected implementation on the same scenario and
+  // report their performance. The threads are created and pinned
+  // once, before any measure.
+  if ((consumer_period == 0) && (producer_period == 0)) {
+    trace_activity = 0;
+    if (!csv_output)
+      printf("benchmark: n_values = %ld, duration = %ld ms\n",
+             n_values, bench_duration);
+    cpus = malloc(sizeof *cpus * (n_consumers + n_producers));
+    team_cpus(n_consumers + n_producers, cpus);
+    team = team_init(n_consumers + n_producers, cpus);
+    if (csv_output) print_csv_header();
+    if (all_impls)
+      for (impl = 0; protected_buffer_impls[impl] != NULL; impl++)
+        run_benchmark(impl);
+    else
+      run_benchmark(sem_impl);
+    team_destroy(team);
+    free(cpus);
+    return 0;
+  }
 
-  get_string (file, "#buffer_size", __FILE__, __LINE__);
-  get_long   (file, (long *) &buffer_size, __FILE__, __LINE__);
-  printf ("buffer_size = %ld\n", buffer_size);
+  protected_buffer = protected_buffer_init(sem_impl, buffer_size);
 
-  get_string (file, "#n_values", __FILE__, __LINE__);
-  get_long   (file, (long *) &n_values, __FILE__, __LINE__);
-  printf ("n_values = %ld\n", n_values);
 
-  get_string (file, "#n_consumers", __FILE__, __LINE__);
-  get_long   (file, (long *) &n_consumers, __FILE__, __LINE__);
-  printf ("n_consumers = %ld\n", n_consumers);
+  set_start_time();
 
-  get_string (file, "#n_producers", __FILE__, __LINE__);
-  get_long   (file, (long *) &n_producers, __FILE__, __LINE__);
-  printf ("n_producers = %ld\n", n_producers);
+  // Run consumers and then producers on a team. Pass the *value* of
+  // i as parametre of the main procedure s(main_consumer or
+  // main_producer).
+  ids=malloc(sizeof *ids*(n_consumers+n_producers));
+  for (i=0; i<n_producers+n_consumers; i++) ids[i] = i;
+  team = team_init(n_consumers+n_producers, NULL);
 
-  get_string (file, "#consumer_period", __FILE__, __LINE__);
-  get_long   (file, (long *) &consumer_period, __FILE__, __LINE__);
-  printf ("consumer_period = %ld\n", consumer_period);
+  // Wait for producers and consumers termination
+  team_run(team, main_member, ids);
+  team_destroy(team);
+  free(ids);
+  protected_buffer_destroy(protected_buffer);
+}
 
-  get_string (file, "#producer_period", __FILE__, __LINE__);
-  get_long   (file, (long *) &producer_period, __FILE__, __LINE__);
-  printf ("producer_period = %ld\n", producer_period);
+void read_file(char * filename){
+  parser_t p;
+  char   * key;
+  int      len, i;
+  parser_field_t fields[] = {
+    {"#sem_impl",        &sem_impl},
+    {"#semantics",       &semantics},
+    {"#buffer_size",     &buffer_size},
+    {"#n_values",        &n_values},
+    {"#n_consumers",     &n_consumers},
+    {"#n_producers",     &n_producers},
+    {"#consumer_period", &consumer_period},
+    {"#producer_period", &producer_period},
+    {NULL}
+  };
+
+  // Keys may come in any order
+  parser_open(&p, filename);
+  while (parser_next_key(&p, &key, &len))
+    parser_read_field(&p, fields, key, len);
+  parser_check_fields(&p, fields);
+  parser_close(&p);
+
+  if (csv_output) return;
+  for (i = 0; fields[i].name != NULL; i++)
+    printf ("%s = %ld\n", fields[i].name + 1, *fields[i].value);
 }
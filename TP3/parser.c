@@ -0,0 +1,188 @@
+#include <fcntl.h>
+#include <limits.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "parser.h"
+
+// Map file filename in memory.
+void parser_open(parser_t * p, char * filename) {
+  struct stat st;
+  int         fd;
+
+  p->filename = filename;
+  fd = open(filename, O_RDONLY);
+  if ((fd < 0) || (fstat(fd, &st) < 0)) {
+    printf("cannot read file %s\n", filename);
+    exit(1);
+  }
+  p->data = NULL;
+  if (st.st_size > 0) {
+    p->data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (p->data == MAP_FAILED) {
+      printf("cannot map file %s\n", filename);
+      exit(1);
+    }
+  }
+  close(fd);
+  p->end        = p->data + st.st_size;
+  p->cur        = p->data;
+  p->line_start = p->data;
+  p->line       = 1;
+}
+
+// Unmap the file.
+void parser_close(parser_t * p) {
+  if (p->data != NULL)
+    munmap(p->data, p->end - p->data);
+  p->data = NULL;
+}
+
+// Report an error at the current position and exit.
+void parser_error(parser_t * p, char * fmt, ...) {
+  va_list ap;
+
+  printf("%s:%ld:%ld: ", p->filename, p->line, (long)(p->cur - p->line_start) + 1);
+  va_start(ap, fmt);
+  vprintf(fmt, ap);
+  va_end(ap);
+  printf("\n");
+  exit(1);
+}
+
+// Skip spaces and tabs of the current line.
+static void skip_spaces(parser_t * p) {
+  while ((p->cur < p->end) &&
+         ((*p->cur == ' ') || (*p->cur == '\t') || (*p->cur == '\r')))
+    p->cur++;
+}
+
+// Skip blanks, including end of lines.
+static void skip_blank_lines(parser_t * p) {
+  while (p->cur < p->end) {
+    if (*p->cur == '\n') {
+      p->cur++;
+      p->line_start = p->cur;
+      p->line++;
+    } else if ((*p->cur == ' ') || (*p->cur == '\t') || (*p->cur == '\r'))
+      p->cur++;
+    else
+      break;
+  }
+}
+
+int parser_next_key(parser_t * p, char ** key, int * len) {
+  char * c;
+
+  skip_blank_lines(p);
+  if (p->cur == p->end) return 0;
+  if (*p->cur != '#')
+    parser_error(p, "expected a key, found '%c'", *p->cur);
+  c = p->cur;
+  while ((c < p->end) && (*c != '\n') && (*c != ' ') &&
+         (*c != '\t') && (*c != '\r'))
+    c++;
+  *key = p->cur;
+  *len = c - p->cur;
+  p->cur = c;
+  return 1;
+}
+
+int parser_key_is(char * key, int len, char * name) {
+  return (strncmp(key, name, len) == 0) && (name[len] == '\0');
+}
+
+int parser_has_value(parser_t * p) {
+  skip_blank_lines(p);
+  return (p->cur < p->end) && (*p->cur != '#');
+}
+
+long parser_long_in_line(parser_t * p) {
+  long value = 0;
+  int  negative = 0;
+  int  digit;
+
+  skip_spaces(p);
+  if ((p->cur < p->end) && ((*p->cur == '-') || (*p->cur == '+'))) {
+    negative = (*p->cur == '-');
+    p->cur++;
+  }
+  if ((p->cur == p->end) || (*p->cur < '0') || ('9' < *p->cur)) {
+    if ((p->cur == p->end) || (*p->cur == '\n'))
+      parser_error(p, "missing integer");
+    parser_error(p, "expected an integer, found '%c'", *p->cur);
+  }
+  while ((p->cur < p->end) && ('0' <= *p->cur) && (*p->cur <= '9')) {
+    digit = *p->cur - '0';
+    if (value > (LONG_MAX - digit) / 10)
+      parser_error(p, "integer too large");
+    value = value * 10 + digit;
+    p->cur++;
+  }
+  return (negative) ? -value : value;
+}
+
+void parser_end_line(parser_t * p) {
+  skip_spaces(p);
+  if (p->cur == p->end) return;
+  if (*p->cur != '\n')
+    parser_error(p, "unexpected '%c' at end of line", *p->cur);
+  p->cur++;
+  p->line_start = p->cur;
+  p->line++;
+}
+
+long parser_long(parser_t * p, char * key) {
+  long value;
+
+  if (!parser_has_value(p))
+    parser_error(p, "missing value for %s", key);
+  value = parser_long_in_line(p);
+  parser_end_line(p);
+  return value;
+}
+
+void parser_skip_values(parser_t * p) {
+  char * c;
+
+  while (parser_has_value(p)) {
+    c = memchr(p->cur, '\n', p->end - p->cur);
+    p->cur = (c == NULL) ? p->end : c;
+  }
+}
+
+parser_field_t * parser_find_field(parser_field_t * fields,
+                                   char * key, int len) {
+  for (; fields->name != NULL; fields++)
+    if (parser_key_is(key, len, fields->name))
+      return fields;
+  return NULL;
+}
+
+void parser_read_field(parser_t * p, parser_field_t * fields,
+                       char * key, int len) {
+  parser_field_t * field = parser_find_field(fields, key, len);
+
+  if (field == NULL) {
+    p->cur = key;
+    parser_error(p, "unknown key %.*s", len, key);
+  }
+  if (field->line != 0) {
+    p->cur = key;
+    parser_error(p, "duplicate key %s (first defined at line %ld)",
+                 field->name, field->line);
+  }
+  field->line = p->line;
+  *field->value = parser_long(p, field->name);
+}
+
+void parser_check_fields(parser_t * p, parser_field_t * fields) {
+  for (; fields->name != NULL; fields++)
+    if (fields->line == 0)
+      parser_error(p, "missing key %s", fields->name);
+}
@@ -0,0 +1,71 @@
+#ifndef PARSER_H
+#define PARSER_H
+
+// Single-pass reader for scenario files. The file is mapped in memory
+// and scanned in place, without any copy or allocation. A scenario
+// file is a sequence of keys ("#name" on a line of their own), each
+// one followed by lines of values. Any error is reported as
+// file:line:column and terminates the program.
+typedef struct {
+  char * filename;
+  char * data;        // Mapped file
+  char * end;         // End of mapped file
+  char * cur;         // Current position
+  char * line_start;  // Start of the current line
+  long   line;        // Current line number (from 1)
+} parser_t;
+
+// Scalar key of a scenario file. line is 0 until the key is read.
+typedef struct {
+  char * name;
+  long * value;
+  long   line;
+} parser_field_t;
+
+// Map file filename in memory.
+void parser_open(parser_t * p, char * filename);
+
+// Unmap the file.
+void parser_close(parser_t * p);
+
+// Report an error at the current position and exit.
+void parser_error(parser_t * p, char * fmt, ...);
+
+// Skip blank lines. Return 0 at end of file. Otherwise, store the
+// next key (including '#') in key and len, move past it and return 1.
+int parser_next_key(parser_t * p, char ** key, int * len);
+
+// Return whether the key stored in key and len is name.
+int parser_key_is(char * key, int len, char * name);
+
+// Skip blank lines and return whether a value (and not a key or the
+// end of file) follows.
+int parser_has_value(parser_t * p);
+
+// Read a value of key on the next non blank line. The line must hold
+// a single integer.
+long parser_long(parser_t * p, char * key);
+
+// Read the next integer of the current line.
+long parser_long_in_line(parser_t * p);
+
+// Check that nothing but blanks remains on the current line and go
+// to the next one.
+void parser_end_line(parser_t * p);
+
+// Skip the values of the current key.
+void parser_skip_values(parser_t * p);
+
+// Find the field of fields (terminated by a NULL name) matching key.
+// Return NULL if there is none.
+parser_field_t * parser_find_field(parser_field_t * fields,
+                                   char * key, int len);
+
+// Read the value of the scalar key matching one of fields. Report an
+// error if the key is unknown or has already been read.
+void parser_read_field(parser_t * p, parser_field_t * fields,
+                       char * key, int len);
+
+// Report an error if one of fields has not been read.
+void parser_check_fields(parser_t * p, parser_field_t * fields);
+#endif
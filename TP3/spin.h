@@ -0,0 +1,27 @@
+#ifndef SPIN_H
+#define SPIN_H
+
+#include <sched.h>
+
+// Spins before a waiting thread yields its processor, in case the
+// thread it waits for is not running (more threads than processors).
+#define SPIN_LIMIT 128
+
+// Tell the processor that the thread is spinning.
+static inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#endif
+}
+
+// One iteration of a wait loop: pause, and yield the processor every
+// SPIN_LIMIT iterations. *spins starts at 0.
+static inline void spin_wait(int * spins) {
+  if (++*spins < SPIN_LIMIT) {
+    cpu_relax();
+  } else {
+    *spins = 0;
+    sched_yield();
+  }
+}
+#endif
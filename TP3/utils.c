@@ -17,6 +17,7 @@ long n_consumers;     // Number of consumers
 long n_producers;     // Number of producers
 long consumer_period; // Period of consumer (millis)
 long producer_period; // Period of producer (millis)
+long trace_activity = 1; // Log buffer operations (0 in benchmark mode)
 
 pthread_mutex_t m ;
 pthread_cond_t cv ; 
@@ -57,6 +58,8 @@ void print_task_activity(char * action, int * data) {
   int * id = (int *)pthread_getspecific(task_info_key);
   char * kind;
 
+  if (!trace_activity) return;
+
   if (*id < n_consumers)
     kind = consumer_name;
   else
@@ -148,39 +151,6 @@ void set_start_time() {
   TIMEVAL_TO_TIMESPEC(&tv_start_time, &start_time);
 }
 
-// Read string in file f and store it in s. If there is an error,
-// provide filename and line number (file:line).
-int get_string (FILE * f, char * s, char * file, int line) {
-  char b[64];
-  char * c;;
-
-  while (fgets (b, 64, f) != NULL) {
-    c = strchr (b, '\n');
-    *c = '\0';
-    if (strcmp (s, b) == 0)
-      return 1;
-  }
-  printf ("getString failed to catch %s in %s:%d\n", s, file, line);
-  exit (1);
-  return 0;
-}
-
-// Read long in file f and store it in l. If there is an error,
-// provide filename and line number (file:line).
-int get_long (FILE * f, long * l, char * file, int line) {
-  char b[64];
-  char * c;;
-
-  if (fgets (b, 64, f) != NULL) {
-    c = strchr (b, '\n');
-    *c = '\0';
-    *l = strtol (b, NULL, 10);
-    if ((*l != 0) || (errno != EINVAL))
-      return 1;
-  }
-  return 0;
-}
-
 #ifdef DARWIN
 int sem_timedwait(sem_t *restrict sem, const struct timespec * abs_timeout){
   struct timeval  tv_now;
@@ -1,6 +1,7 @@
 #ifndef UTILS_H
 #define UTILS_H
 #include <pthread.h>
+#include <semaphore.h>
 #include <sys/time.h>
 #ifdef DARWIN
 #define TIMEVAL_TO_TIMESPEC(tv, ts) {                                   \
@@ -28,6 +29,7 @@ extern long n_consumers;     // Number of consumers
 extern long n_producers;     // Number of producers
 extern long consumer_period; // Period of consumer (millis)
 extern long producer_period; // Period of producer (millis)
+extern long trace_activity;  // Log buffer operations (0 in benchmark mode)
 
 // Initialize the data structure used in this unti
 void init_utils();
@@ -51,12 +53,4 @@ struct timespec get_start_time();
 
 // Store current time as the start time
 void set_start_time();
-
-// Read long in file f and store it in l. If there is an error,
-// provide filename and line number (file:line).
-int get_long (FILE * f, long * l, char * file, int line);
-
-// Read string in file f and store it in s. If there is an error,
-// provide filename and line number (file:line).
-int get_string (FILE * f, char * s, char * file, int line);
 #endif
@@ -19,4 +19,7 @@ void * circular_buffer_read(circular_buffer_t * b);
 int circular_buffer_put(circular_buffer_t * b, void * d);
 
 int circular_buffer_size(circular_buffer_t * b);
+
+// Free the circular buffer structure, but not the elements it holds.
+void circular_buffer_destroy(circular_buffer_t * b);
 #endif
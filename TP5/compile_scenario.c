@@ -0,0 +1,22 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "scenario.h"
+#include "snapshot.h"
+#include "utils.h"
+
+// Compile a text scenario into an image that main_executor maps in
+// memory instead of parsing it (see snapshot.h).
+int main(int argc, char *argv[]) {
+  if (argc != 3) {
+    printf("Usage : %s <scenario file> <image file>\n", argv[0]);
+    exit(1);
+  }
+
+  trace_activity = 0;
+  readFile(argv[1]);
+  snapshot_write(argv[2]);
+  printf("%s: %ld jobs, %ld dependencies\n",
+         argv[2], job_table_size, deps.n_edges);
+  return 0;
+}
@@ -4,30 +4,45 @@
 #include <stdio.h>
 #include "circular_buffer.h"
 #include "protected_buffer.h"
+#include "cond_protected_buffer.h"
 #include "utils.h"
 
+const protected_buffer_ops_t cond_protected_buffer_ops = {
+  "cond",
+  cond_protected_buffer_init,
+  cond_protected_buffer_get,
+  cond_protected_buffer_put,
+  cond_protected_buffer_remove,
+  cond_protected_buffer_add,
+  cond_protected_buffer_poll,
+  cond_protected_buffer_offer,
+  cond_protected_buffer_destroy,
+};
+
 // Initialise the protected buffer structure above.
 protected_buffer_t * cond_protected_buffer_init(int length) {
-  protected_buffer_t * b;
-  b = (protected_buffer_t *)malloc(sizeof(protected_buffer_t));
-  b->buffer = circular_buffer_init(length);
+  cond_protected_buffer_t * b;
+  b = (cond_protected_buffer_t *)malloc(sizeof(cond_protected_buffer_t));
+  b->base.ops = &cond_protected_buffer_ops;
+  b->base.buffer = circular_buffer_init(length);
   // Initialize the synchronization components
   pthread_mutex_init(&(b->mutex), NULL);
   pthread_cond_init(&(b->condEmpty), NULL);
   pthread_cond_init(&(b->condFull), NULL);
-  return b;
+  return &(b->base);
 }
 
 // Extract an element from buffer. If the attempted operation is
 // not possible immedidately, the method call blocks until it is.
-void * cond_protected_buffer_get(protected_buffer_t * b){
+void * cond_protected_buffer_get(protected_buffer_t * pb){
+  cond_protected_buffer_t * b = (cond_protected_buffer_t *)pb;
   void * d;
 
   // Enter mutual exclusion
   pthread_mutex_lock(&(b->mutex));
   // Wait until there is a full slot to get data from the unprotected
   // circular buffer (circular_buffer_get).
-  while ((d = circular_buffer_get(b->buffer)) == NULL){
+  while ((d = circular_buffer_get(b->base.buffer)) == NULL){
     pthread_cond_wait(&(b->condFull), &(b->mutex));
   }
   // Signal or broadcast that an empty slot is available in the
@@ -43,20 +58,20 @@ void * cond_protected_buffer_get(protected_buffer_t * b){
 
 // Insert an element into buffer. If the attempted operation is
 // not possible immedidately, the method call blocks until it is.
-void cond_protected_buffer_put(protected_buffer_t * b, void * d){
+void cond_protected_buffer_put(protected_buffer_t * pb, void * d){
+  cond_protected_buffer_t * b = (cond_protected_buffer_t *)pb;
 
   // Enter mutual exclusionss
   pthread_mutex_lock(&(b->mutex));
   // Wait until there is an empty slot to put data in the unprotected
   // circular buffer (circular_buffer_put).
-  while (circular_buffer_put(b->buffer, d) == 0) {
+  while (circular_buffer_put(b->base.buffer, d) == 0) {
     pthread_cond_wait(&(b->condEmpty), &(b->mutex));
   }
   // Signal or broadcast that a full slot is available in the
   // unprotected circular buffer (if needed)
   pthread_cond_broadcast(&(b->condFull));
 
-  circular_buffer_put(b->buffer, d);
   print_task_activity ("put", d);
 
   // Leave mutual exclusion
@@ -66,11 +81,12 @@ void cond_protected_buffer_put(protected_buffer_t * b, void * d){
 
 // Extract an element from buffer. If the attempted operation is not
 // possible immedidately, return NULL. Otherwise, return the element.
-void * cond_protected_buffer_remove(protected_buffer_t * b){
+void * cond_protected_buffer_remove(protected_buffer_t * pb){
+  cond_protected_buffer_t * b = (cond_protected_buffer_t *)pb;
   void * d;
 
   pthread_mutex_lock(&(b->mutex));
-  d = circular_buffer_get(b->buffer);
+  d = circular_buffer_get(b->base.buffer);
   if (d != NULL) {
     pthread_cond_broadcast(&(b->condEmpty));
   }
@@ -86,14 +102,15 @@ void * cond_protected_buffer_remove(protected_buffer_t * b){
 
 // Insert an element into buffer. If the attempted operation is
 // not possible immedidately, return 0. Otherwise, return 1.
-int cond_protected_buffer_add(protected_buffer_t * b, void * d){
+int cond_protected_buffer_add(protected_buffer_t * pb, void * d){
+  cond_protected_buffer_t * b = (cond_protected_buffer_t *)pb;
   int done;
 
   // Enter mutual exclusion
   pthread_mutex_lock(&(b->mutex));
   // Signal or broadcast that a full slot is available in the
   // unprotected circular buffer (if needed)
-  done = circular_buffer_put(b->buffer, d);
+  done = circular_buffer_put(b->base.buffer, d);
 
   if (!done) d = NULL;
 
@@ -110,7 +127,8 @@ int cond_protected_buffer_add(protected_buffer_t * b, void * d){
 // possible immedidately, the method call blocks until it is, but
 // waits no longer than the given timeout. Return the element if
 // successful. Otherwise, return NULL.
-void * cond_protected_buffer_poll(protected_buffer_t * b, struct timespec *abstime){
+void * cond_protected_buffer_poll(protected_buffer_t * pb, struct timespec *abstime){
+  cond_protected_buffer_t * b = (cond_protected_buffer_t *)pb;
   void * d = NULL;
   int    rc = 0;
 
@@ -120,27 +138,15 @@ void * cond_protected_buffer_poll(protected_buffer_t * b, struct timespec *absti
   // circular buffer (circular_buffer_put) but waits no longer than
   // the given timeout.
 
-  /*
-  while ((d = circular_buffer_get(b->buffer)) == NULL){
-    rc = pthread_cond_timedwait(&(b->condEmpty), &(b->mutex),abstime);
-    if (rc == ETIMEDOUT) break;
-  }
-  */
-
-  // We are putting NULL in the buffer during shutdown so this is 
-  // increasing the time of shutdown
-  
-  while(b->buffer->size == 0 ){
-    d=circular_buffer_get(b->buffer);
-    rc = pthread_cond_timedwait(&(b->condFull), &(b->mutex),abstime) ;
-    if (rc == ETIMEDOUT) break ;
+  while ((d = circular_buffer_get(b->base.buffer)) == NULL){
+    rc = pthread_cond_timedwait(&(b->condFull), &(b->mutex),abstime);
+    if (rc == ETIMEDOUT)break;
   }
-
   // Signal or broadcast that a full slot is available in the
   // unprotected circular buffer (if needed)
-  if((d = circular_buffer_get(b->buffer)) != NULL) 
+  if (d != NULL) {
     pthread_cond_broadcast(&(b->condEmpty));
-
+  }
   print_task_activity ("poll", d);
 
   // Leave mutual exclusion
@@ -152,7 +158,8 @@ void * cond_protected_buffer_poll(protected_buffer_t * b, struct timespec *absti
 // possible immedidately, the method call blocks until it is, but
 // waits no longer than the given timeout. Return 0 if not
 // successful. Otherwise, return 1.
-int cond_protected_buffer_offer(protected_buffer_t * b, void * d, struct timespec * abstime){
+int cond_protected_buffer_offer(protected_buffer_t * pb, void * d, struct timespec * abstime){
+  cond_protected_buffer_t * b = (cond_protected_buffer_t *)pb;
   int rc = 0;
   int done = 0;
 
@@ -161,14 +168,14 @@ int cond_protected_buffer_offer(protected_buffer_t * b, void * d, struct timespe
   // Signal or broadcast that a full slot is available in the
   // unprotected circular buffer (if needed) but waits no longer than
   // the given timeout.
-  while ((done = circular_buffer_put(b->buffer,d)) == 0){
-    rc = pthread_cond_timedwait(&(b->condFull), &(b->mutex),abstime);
+  while ((done = circular_buffer_put(b->base.buffer,d)) == 0){
+    rc = pthread_cond_timedwait(&(b->condEmpty), &(b->mutex),abstime);
     if (rc == ETIMEDOUT)break;
   }
   // Signal or broadcast that a full slot is available in the
   // unprotected circular buffer (if needed)
-  if (rc != ETIMEDOUT)
-    pthread_cond_broadcast(&(b->condEmpty));
+  if (done)
+    pthread_cond_broadcast(&(b->condFull));
 
   if (!done) d = NULL;
   print_task_activity ("offer", d);
@@ -177,3 +184,14 @@ int cond_protected_buffer_offer(protected_buffer_t * b, void * d, struct timespe
   pthread_mutex_unlock(&(b->mutex));
   return done;
 }
+
+// Release the synchronisation components and the memory of buffer.
+void cond_protected_buffer_destroy(protected_buffer_t * pb){
+  cond_protected_buffer_t * b = (cond_protected_buffer_t *)pb;
+
+  pthread_mutex_destroy(&(b->mutex));
+  pthread_cond_destroy(&(b->condEmpty));
+  pthread_cond_destroy(&(b->condFull));
+  circular_buffer_destroy(b->base.buffer);
+  free(b);
+}
@@ -1,11 +1,21 @@
 #ifndef COND_PROTECTED_BUFFER_H
 #define COND_PROTECTED_BUFFER_H
 #include <pthread.h>
-#include <semaphore.h>
 #include <stdlib.h>
 #include "circular_buffer.h"
 #include "protected_buffer.h"
 
+// Protected buffer synchronised by a mutex and cond variables.
+typedef struct {
+  protected_buffer_t base;
+  pthread_mutex_t mutex;
+  pthread_cond_t condEmpty;
+  pthread_cond_t condFull;
+} cond_protected_buffer_t;
+
+// Operations of the implementation ("cond").
+extern const protected_buffer_ops_t cond_protected_buffer_ops;
+
 // Initialise the protected buffer structure above.
 protected_buffer_t * cond_protected_buffer_init(int length);
 
@@ -36,4 +46,7 @@ void * cond_protected_buffer_poll(protected_buffer_t * b, struct timespec * abst
 // waits no longer than the given timeout. Return 0 if not
 // successful. Otherwise, return 1.
 int cond_protected_buffer_offer(protected_buffer_t * b, void * d, struct timespec * abstime);
+
+// Release the synchronisation components and the memory of buffer.
+void cond_protected_buffer_destroy(protected_buffer_t * b);
 #endif
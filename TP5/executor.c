@@ -7,6 +7,11 @@
 pthread_mutex_t mts0;
 pthread_cond_t  cvts0;
 
+// Queued once per pool thread by executor_shutdown. A thread getting
+// it from the blocking queue leaves the pool. NULL cannot be used as
+// the blocking queue never returns NULL elements from a blocking get.
+future_t shutdown_future;
+
 // Main for threads executing callables
 void * main_pool_thread (void * arg);
 
@@ -55,16 +60,25 @@ future_t * submit_callable (executor_t * executor, callable_t * callable) {
   // When the queue is full, pop the first future from the queue and
   // push the current one.
   future_t * first = protected_buffer_remove(executor->futures);
-  if (first != NULL) {
-    protected_buffer_add(executor->futures, future); // we add the curent callable
-    future = first; // attribute popped collable to current thread
+  if (first == NULL) {
+    // The pool threads emptied the queue in the meantime
+    protected_buffer_put(executor->futures, future);
+    return future;
   }
 
   // Try to create a thread, but allow to exceed core_pool_size (last
-  // parameter set to true).
-  pool_thread_create (executor->thread_pool, main_pool_thread, future, 1);
+  // parameter set to true). The new thread executes the popped
+  // callable and the current one takes its slot in the queue.
+  if (pool_thread_create (executor->thread_pool, main_pool_thread, first, 1)) {
+    protected_buffer_put(executor->futures, future);
+    return future;
+  }
 
-  return future;
+  // The pool has reached max_pool_size. Queue the popped callable
+  // again and reject the current one.
+  protected_buffer_put(executor->futures, first);
+  free(future);
+  return NULL;
 }
 
 // Get result from callable execution. Block if not available.
@@ -129,33 +143,32 @@ void * main_pool_thread (void * arg) {
     }
 
     future = NULL;
-    if (executor->keep_alive_time == FOREVER) {
-      // If the executor does not deallocate pool threads after being
-      // inactive for a xhile, just wait for the next available
-      // callable / future.
-      future = (future_t *) protected_buffer_get(executor->futures);
-      // If there is no callable to handle, remove the current pool
-      // thread from the pool.
-      if ((future == NULL) && pool_thread_remove(executor->thread_pool))
-        break;
-
-    } else {
-      // If the executor is configured to release a thread when it is
-      // idle for keep_alive_time milliseconds, try to get a new
-      // callable / future during at most keep_alive_time ms.
-      struct timespec      ts;
-      struct timeval       tv;
-      gettimeofday (&tv, NULL);
-      TIMEVAL_TO_TIMESPEC (&tv, &ts);
-      add_millis_to_timespec (&ts, executor->keep_alive_time);
-
-      future = (future_t *) protected_buffer_poll(executor->futures, &ts);
+    while (future == NULL) {
+      if (executor->keep_alive_time == FOREVER) {
+        // If the executor does not deallocate pool threads after being
+        // inactive for a xhile, just wait for the next available
+        // callable / future.
+        future = (future_t *) protected_buffer_get(executor->futures);
+
+      } else {
+        // If the executor is configured to release a thread when it is
+        // idle for keep_alive_time milliseconds, try to get a new
+        // callable / future during at most keep_alive_time ms.
+        struct timespec      ts;
+        struct timeval       tv;
+        gettimeofday (&tv, NULL);
+        TIMEVAL_TO_TIMESPEC (&tv, &ts);
+        add_millis_to_timespec (&ts, executor->keep_alive_time);
+
+        future = (future_t *) protected_buffer_poll(executor->futures, &ts);
+      }
+      if (future == &shutdown_future) future = NULL;
 
       // If there is no callable to handle, remove the current pool
-      // thread from the pool. And then, complete.
+      // thread from the pool. And then, complete. Threads within
+      // core_pool_size stay in the pool until shutdown.
       if ((future == NULL) && pool_thread_remove (executor->thread_pool))
-        break;
-
+        return NULL;
     }
   }
   return NULL;
@@ -164,13 +177,18 @@ void * main_pool_thread (void * arg) {
 // Wait for pool threads to be completed
 void executor_shutdown (executor_t * executor) {
   thread_pool_t * thread_pool = executor->thread_pool;
+  int i, size;
+
   thread_pool_shutdown(thread_pool);
 
-  // Fill the queue of null futures to unblock potential threads
-  // protected_buffer_add() returns 1 if the operation is permitted and 0 if not
-  while (protected_buffer_add(executor->futures, NULL));
+  // Queue one shutdown future per pool thread to unblock the threads
+  // waiting for a callable. Each of them leaves the pool when it gets
+  // one.
+  size = get_pool_size(thread_pool);
+  for (i = 0; i < size; i++)
+    protected_buffer_put(executor->futures, &shutdown_future);
 
-  
   wait_thread_pool_empty(executor->thread_pool);
-  printf ("%06ld [executor_shutdown]\n", relative_clock());
+  if (trace_activity)
+    printf ("%06ld [executor_shutdown]\n", relative_clock());
 }
@@ -4,6 +4,7 @@
 #include <string.h>
 #include <unistd.h>
 
+#include "bench.h"
 #include "executor.h"
 #include "scenario.h"
 #include "utils.h"
@@ -11,6 +12,17 @@
 callable_t * callables;
 future_t ** futures;
 
+// Report results as CSV. Each job then records when it was submitted,
+// started and completed (monotonic clock, ns).
+long   csv_output = 0;
+long * submit_ns;
+long * start_ns;
+long * complete_ns;
+
+// When jobs are released according to their dependencies, each job
+// puts itself in this queue once completed.
+protected_buffer_t * completions = NULL;
+
 void * main_job (void * arg) {
   job_t * job = (job_t *) arg;
   struct timespec ts1, ts2;
@@ -18,19 +30,137 @@ void * main_job (void * arg) {
   ts1.tv_sec  = job->exec_time / 1000;
   ts1.tv_nsec = (job->exec_time % 1000) * 1000000;
 
-  printf("%06ld [main_job] initiate execution=%ld period=%ld\n",
-         relative_clock(), job->exec_time, period);
-  nanosleep(&ts1, &ts2);
-  printf("%06ld [main_job] complete execution=%ld period=%ld\n",
-         relative_clock(), job->exec_time, period);
+  if (csv_output) {
+    start_ns[job->id] = bench_now_ns();
+    if (job->exec_time) nanosleep(&ts1, &ts2);
+    complete_ns[job->id] = bench_now_ns();
+  } else {
+    printf("%06ld [main_job] initiate execution=%ld period=%ld\n",
+           relative_clock(), job->exec_time, period);
+    nanosleep(&ts1, &ts2);
+    printf("%06ld [main_job] complete execution=%ld period=%ld\n",
+           relative_clock(), job->exec_time, period);
+  }
+  if (completions != NULL)
+    protected_buffer_put(completions, job);
   return NULL;
 }
 
-int main(int argc, char *argv[]) {
-  int i;
+// Associate job i to a callable and submit it to executor.
+void submit_job(executor_t * executor, int i) {
+  callables[i].params = (void *) &jobs[i];
+  callables[i].main   = main_job;
+  callables[i].period = period;
+
+  // Submit callable to executor
+  if (submit_ns[i] == 0) submit_ns[i] = bench_now_ns();
+  futures[i] = submit_callable (executor, &callables[i]);
+  if (csv_output)
+    return;
+  if (futures[i] == NULL)
+    printf ("%06ld [submit_callable] id %d failed\n", relative_clock(), i);
+  else
+    printf ("%06ld [submit_callable] id %d\n", relative_clock(), i);
+}
+
+#ifdef DEPS
+// Submit each job once all its predecessors have completed. Only the
+// main thread updates the in_degree counters: it waits for completed
+// jobs and releases their successors, so releasing a job costs its
+// number of successors. A rejected job is submitted again after the
+// next completion.
+void submit_jobs_with_deps(executor_t * executor) {
+  long  * ready = (long *) malloc(job_table_size * sizeof(long));
+  long    n_ready = 0, n_running = 0, n_completed = 0, i, k;
+  job_t * job;
+
+  completions = protected_buffer_init(0, job_table_size);
+  for (i = 0; i < job_table_size; i++)
+    if (deps.in_degree[i] == 0) {
+      ready[n_ready++] = i;
+      submit_ns[i] = bench_now_ns();
+    }
+
+  while (n_completed < job_table_size) {
+    while (n_ready > 0) {
+      submit_job(executor, ready[n_ready - 1]);
+      if (futures[ready[n_ready - 1]] == NULL) break;
+      n_ready--;
+      n_running++;
+    }
+    if (n_running == 0) {
+      printf("cannot submit job %ld\n", ready[n_ready - 1]);
+      exit(1);
+    }
+
+    job = (job_t *) protected_buffer_get(completions);
+    n_running--;
+    n_completed++;
+    for (k = deps.succ_index[job->id]; k < deps.succ_index[job->id + 1]; k++) {
+      i = deps.succs[k];
+      if (--deps.in_degree[i] == 0) {
+        ready[n_ready++] = i;
+        submit_ns[i] = bench_now_ns();
+      }
+    }
+  }
+  free(ready);
+}
+#endif
+
+// Print the scenario parameters and the executor performance as CSV:
+// jobs per second, and latency from submission to start (wait) and
+// to completion (response) of the jobs that were not rejected.
+void print_csv(executor_t * executor, long t0, long t1) {
+  latency_histogram_t wait, response;
+  double              user, sys, elapsed = (t1 - t0) / 1E9;
+  long                n_rejected = 0;
+  int                 i;
+
+  latency_histogram_init(&wait);
+  latency_histogram_init(&response);
+  for (i = 0; i < job_table_size; i++) {
+    if (futures[i] == NULL) {
+      n_rejected++;
+      continue;
+    }
+    latency_histogram_add(&wait, start_ns[i] - submit_ns[i]);
+    latency_histogram_add(&response, complete_ns[i] - submit_ns[i]);
+  }
+  bench_cpu_time(&user, &sys);
+
+  printf("core_pool_size,max_pool_size,blocking_queue_size,keep_alive_time,"
+         "period,job_table_size,rejected,threads_created,elapsed_s,"
+         "jobs_per_s,cpu_user_s,cpu_sys_s");
+  latency_histogram_csv_header("wait");
+  latency_histogram_csv_header("response");
+  printf("\n%ld,%ld,%ld,%ld,%ld,%ld,%ld,%d,%.6f,",
+         core_pool_size, max_pool_size, blocking_queue_size, keep_alive_time,
+         period, job_table_size, n_rejected,
+         executor->thread_pool->n_created, elapsed);
+  // Periodic jobs never complete: elapsed only covers their
+  // submission, so throughput and latencies are left empty.
+  if (period == 0)
+    printf("%.0f", (job_table_size - n_rejected) / elapsed);
+  printf(",%.3f,%.3f", user, sys);
+  if (period == 0) {
+    latency_histogram_csv(&wait);
+    latency_histogram_csv(&response);
+  } else
+    printf(",,,,,,,,,,,,");
+  printf("\n");
+}
 
-  if (argc != 2) {
-    printf("Usage : %s <scenario file>\n", argv[0]);
+int main(int argc, char *argv[]) {
+  int  i;
+  long t0, t1;
+
+  if ((argc == 3) && (strcmp(argv[2], "-c") == 0)) {
+    csv_output = 1;
+    trace_activity = 0;
+  } else if (argc != 2) {
+    printf("Usage : %s <scenario file> [-c]\n", argv[0]);
+    printf("  -c : report jobs throughput and latency as CSV\n");
     exit(1);
   }
 
@@ -45,8 +175,12 @@ int main(int argc, char *argv[]) {
   // and stored in a Future when available.
   callables = (callable_t *) malloc(sizeof(callable_t) * job_table_size);
   futures = (future_t **) malloc(sizeof(future_t *) * job_table_size);
+  submit_ns = (long *) calloc(job_table_size, sizeof(long));
+  start_ns = (long *) calloc(job_table_size, sizeof(long));
+  complete_ns = (long *) calloc(job_table_size, sizeof(long));
 
   set_start_time();
+  t0 = bench_now_ns();
 
   // Create an executor composed of a thread pool configured with
   // core_pool_size and max_pool_size, a blocking queue (for pending
@@ -62,19 +196,15 @@ int main(int argc, char *argv[]) {
 
   // Each job is associated to a callable. This callable is submitted
   // to the executor which will execute it when a thread from its
-  // threadpool becomes available.
-  for (i = 0; i < job_table_size; i++) {
-    callables[i].params = (void *) &jobs[i];
-    callables[i].main   = main_job;
-    callables[i].period = period;
-
-    // Submit callable to executor
-    futures[i] = submit_callable (executor, &callables[i]);
-    if (futures[i] == NULL)
-      printf ("%06ld [submit_callable] id %d failed\n", relative_clock(), i);
-    else
-      printf ("%06ld [submit_callable] id %d\n", relative_clock(), i);
-  }
+  // threadpool becomes available. Periodic jobs never complete, so
+  // they cannot release their successors.
+#ifdef DEPS
+  if ((period == 0) && (deps.n_edges != 0))
+    submit_jobs_with_deps(executor);
+  else
+#endif
+  for (i = 0; i < job_table_size; i++)
+    submit_job(executor, i);
 
   // When the callables are periodic, there is no result to wait for.
   if (period == 0) {
@@ -85,10 +215,17 @@ int main(int argc, char *argv[]) {
         // Get result from future associated to callable. Suspend until
         // result becomes available.
         result = get_callable_result (futures[i]);
-        printf ("%06ld [get_callable_result] id %d\n", relative_clock(), i);
+        if (!csv_output)
+          printf ("%06ld [get_callable_result] id %d\n", relative_clock(), i);
       }
     }
   }
-  sleep (10);
+  t1 = bench_now_ns();
+
+  // Let idle threads reach keep_alive_time unless we only measure
+  if (!csv_output || period)
+    sleep (10);
   executor_shutdown(executor);
+  if (csv_output)
+    print_csv(executor, t0, t1);
 }
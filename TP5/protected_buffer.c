@@ -1,74 +1,47 @@
+#include <string.h>
 #include "protected_buffer.h"
 #include "cond_protected_buffer.h"
 #include "sem_protected_buffer.h"
 
-// Initialise the protected buffer structure above. sem_impl specifies
-// whether the implementation is a semaphore based implementation.
-protected_buffer_t * protected_buffer_init(long sem_impl, int length) {
-  protected_buffer_t * b;
-  if (sem_impl)
-    b = sem_protected_buffer_init(length);
-  else
-    b = cond_protected_buffer_init(length);
-  b->sem_impl = sem_impl;
-  return b;
-}
-
-// Extract an element from buffer. If the attempted operation is
-// not possible immedidately, the method call blocks until it is.
-void * protected_buffer_get(protected_buffer_t * b){
-  if (b->sem_impl)
-    return sem_protected_buffer_get(b);
-  else
-    return cond_protected_buffer_get(b);
-}
-
-// Insert an element into buffer. If the attempted operation is
-// not possible immedidately, the method call blocks until it is.
-void protected_buffer_put(protected_buffer_t * b, void * d){
-  if (b->sem_impl)
-    sem_protected_buffer_put(b, d);
-  else
-    cond_protected_buffer_put(b, d);
+const protected_buffer_ops_t * protected_buffer_impls[] = {
+#ifdef PROTECTED_BUFFER_IMPL
+  &PROTECTED_BUFFER_OPS,
+#else
+  &cond_protected_buffer_ops,
+  &fsem_protected_buffer_ops,
+  &glibc_sem_protected_buffer_ops,
+#endif
+  NULL
+};
+
+long protected_buffer_find(char * name) {
+  for (long i = 0; protected_buffer_impls[i] != NULL; i++)
+    if (strcmp(protected_buffer_impls[i]->name, name) == 0)
+      return i;
+  return -1;
 }
 
-// Extract an element from buffer. If the attempted operation is not
-// possible immedidately, return NULL. Otherwise, return the element.
-void * protected_buffer_remove(protected_buffer_t * b){
-  if (b->sem_impl)
-    return sem_protected_buffer_remove(b);
-  else
-    return cond_protected_buffer_remove(b);
+// Return the implementation selected by sem_impl. As before there
+// were several semaphore based implementations, any other non-zero
+// value selects the first of them (the only implementation of a
+// single implementation build).
+static const protected_buffer_ops_t * impl_ops(long sem_impl) {
+  long n = 0;
+
+  while (protected_buffer_impls[n] != NULL) n++;
+  if ((sem_impl < 0) || (n <= sem_impl))
+    sem_impl = (n > 1) ? 1 : 0;
+  return protected_buffer_impls[sem_impl];
 }
 
-// Insert an element into buffer. If the attempted operation is
-// not possible immedidately, return 0. Otherwise, return 1.
-int protected_buffer_add(protected_buffer_t * b, void * d){
-  if (b->sem_impl)
-    return sem_protected_buffer_add(b, d);
-  else
-    return cond_protected_buffer_add(b, d);
+// Return a short name for the implementation selected by sem_impl.
+char * protected_buffer_impl_name(long sem_impl) {
+  return impl_ops(sem_impl)->name;
 }
 
-// Extract an element from buffer. If the attempted operation is not
-// possible immedidately, the method call blocks until it is, but
-// waits no longer than the given timeout. Return the element if
-// successful. Otherwise, return NULL.
-void * protected_buffer_poll(protected_buffer_t * b, struct timespec *abstime){
-  if (b->sem_impl)
-    return sem_protected_buffer_poll(b, abstime);
-  else
-    return cond_protected_buffer_poll(b, abstime);
-}
-
-// Insert an element into buffer. If the attempted operation is not
-// possible immedidately, the method call blocks until it is, but
-// waits no longer than the given timeout. Return 0 if not
-// successful. Otherwise, return 1.
-int protected_buffer_offer(protected_buffer_t * b, void * d, struct timespec * abstime){
-  if (b->sem_impl)
-    return sem_protected_buffer_offer(b, d, abstime);
-  else
-    return cond_protected_buffer_offer(b, d, abstime);
+// Initialise the protected buffer structure above. sem_impl selects
+// the implementation, whose operations are then reached through
+// b->ops.
+protected_buffer_t * protected_buffer_init(long sem_impl, int length) {
+  return impl_ops(sem_impl)->init(length);
 }
-
@@ -1,51 +1,116 @@
 #ifndef PROTECTED_BUFFER_H
 #define PROTECTED_BUFFER_H
 #include <pthread.h>
-#include <semaphore.h>
 #include <stdlib.h>
+#include <time.h>
 #include "circular_buffer.h"
 
-// Protected buffer structure used for both implemantations.
+typedef struct protected_buffer_ops protected_buffer_ops_t;
+
+// Part of the protected buffer structure common to all the
+// implementations. Each implementation extends it with its own
+// synchronisation components (see cond_protected_buffer.h and
+// sem_protected_buffer.h), so that a buffer only carries the ones it
+// uses.
 typedef struct {
-  long                sem_impl;
+  const protected_buffer_ops_t * ops;
   circular_buffer_t * buffer;
-  pthread_mutex_t mutex;
-  pthread_cond_t condEmpty;
-  pthread_cond_t condFull;
-  sem_t sem_mutex;
-  sem_t semEmpty;
-  sem_t semFull;
 } protected_buffer_t;
 
-// Initialise the protected buffer structure above. sem_impl specifies
-// whether the implementation is a semaphore based implementation.
+// Operations of an implementation, see the protected_buffer_*
+// functions below.
+struct protected_buffer_ops {
+  char * name;
+  protected_buffer_t * (*init)(int length);
+  void * (*get)(protected_buffer_t * b);
+  void (*put)(protected_buffer_t * b, void * d);
+  void * (*remove)(protected_buffer_t * b);
+  int (*add)(protected_buffer_t * b, void * d);
+  void * (*poll)(protected_buffer_t * b, struct timespec * abstime);
+  int (*offer)(protected_buffer_t * b, void * d, struct timespec * abstime);
+  void (*destroy)(protected_buffer_t * b);
+};
+
+// Implementations, terminated by NULL. sem_impl is an index in this
+// table: 0 for cond variables ("cond"), 1 for futex semaphores
+// ("sem"), 2 for POSIX semaphores ("glibc-sem"). A new implementation
+// only has to provide its operations and be added to the table.
+//
+// When built with PROTECTED_BUFFER_IMPL set to the prefix of an
+// implementation (e.g. make IMPL=cond), it is the only one in the
+// table whatever sem_impl, and the protected_buffer_* functions call
+// its operations without going through b->ops, so that the compiler
+// (with link time optimisation) can inline them.
+extern const protected_buffer_ops_t * protected_buffer_impls[];
+
+// Return the index of the implementation of the given name, -1 if
+// unknown.
+long protected_buffer_find(char * name);
+
+// Return a short name for the implementation selected by sem_impl.
+char * protected_buffer_impl_name(long sem_impl);
+
+// Initialise the protected buffer structure above. sem_impl selects
+// the implementation, whose operations are then reached through
+// b->ops.
 protected_buffer_t * protected_buffer_init(long sem_impl, int length);
 
+#ifdef PROTECTED_BUFFER_IMPL
+#define PROTECTED_BUFFER_PASTE(impl) impl ## _protected_buffer_ops
+#define PROTECTED_BUFFER_OPS_OF(impl) PROTECTED_BUFFER_PASTE(impl)
+#define PROTECTED_BUFFER_OPS PROTECTED_BUFFER_OPS_OF(PROTECTED_BUFFER_IMPL)
+extern const protected_buffer_ops_t PROTECTED_BUFFER_OPS;
+#define PROTECTED_BUFFER_OPS_PTR(b) (&PROTECTED_BUFFER_OPS)
+#else
+#define PROTECTED_BUFFER_OPS_PTR(b) ((b)->ops)
+#endif
+
 // Extract an element from buffer. If the attempted operation is
 // not possible immedidately, the method call blocks until it is.
-void * protected_buffer_get(protected_buffer_t * b);
+static inline void * protected_buffer_get(protected_buffer_t * b) {
+  return PROTECTED_BUFFER_OPS_PTR(b)->get(b);
+}
 
 // Insert an element into buffer. If the attempted operation is
 // not possible immedidately, the method call blocks until it is.
-void protected_buffer_put(protected_buffer_t * b, void * d);
+static inline void protected_buffer_put(protected_buffer_t * b, void * d) {
+  PROTECTED_BUFFER_OPS_PTR(b)->put(b, d);
+}
 
 // Extract an element from buffer. If the attempted operation is not
 // possible immedidately, return NULL. Otherwise, return the element.
-void * protected_buffer_remove(protected_buffer_t * b);
+static inline void * protected_buffer_remove(protected_buffer_t * b) {
+  return PROTECTED_BUFFER_OPS_PTR(b)->remove(b);
+}
 
 // Insert an element into buffer. If the attempted operation is
 // not possible immedidately, return 0. Otherwise, return 1.
-int protected_buffer_add(protected_buffer_t * b, void * d);
+static inline int protected_buffer_add(protected_buffer_t * b, void * d) {
+  return PROTECTED_BUFFER_OPS_PTR(b)->add(b, d);
+}
 
 // Extract an element from buffer. If the attempted operation is not
 // possible immedidately, the method call blocks until it is, but
 // waits no longer than the given timeout. Return the element if
 // successful. Otherwise, return NULL.
-void * protected_buffer_poll(protected_buffer_t * b, struct timespec * abstime);
+static inline void * protected_buffer_poll(protected_buffer_t * b,
+                                           struct timespec * abstime) {
+  return PROTECTED_BUFFER_OPS_PTR(b)->poll(b, abstime);
+}
 
 // Insert an element into buffer. If the attempted operation is not
 // possible immedidately, the method call blocks until it is, but
 // waits no longer than the given timeout. Return 0 if not
 // successful. Otherwise, return 1.
-int protected_buffer_offer(protected_buffer_t * b, void * d, struct timespec * abstime);
+static inline int protected_buffer_offer(protected_buffer_t * b, void * d,
+                                         struct timespec * abstime) {
+  return PROTECTED_BUFFER_OPS_PTR(b)->offer(b, d, abstime);
+}
+
+// Release the synchronisation components and the memory of buffer,
+// which no thread may use any longer. The elements still in the
+// buffer are not freed.
+static inline void protected_buffer_destroy(protected_buffer_t * b) {
+  PROTECTED_BUFFER_OPS_PTR(b)->destroy(b);
+}
 #endif
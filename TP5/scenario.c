@@ -3,7 +3,10 @@
 #include <string.h>
 #include <errno.h>
 
+#include "parser.h"
 #include "scenario.h"
+#include "snapshot.h"
+#include "utils.h"
 
 long      job_table_size;
 long      core_pool_size;
@@ -12,77 +15,221 @@ long      blocking_queue_size;
 long      keep_alive_time;
 long      period;
 job_t   * jobs;
+deps_t    deps;
 
-int getString (FILE * f, char * s, char * file, int line) {
-  char b[64];
-  char * c;;
-  
-  while (fgets (b, 64, f) != NULL) {
-    c = strchr (b, '\n');
-    *c = '\0';
-    if (strcmp (s, b) == 0)
-      return 1;
+// Read the job_table_size values of #exec_time.
+void readExecTime (parser_t * p) {
+  ulong i;
+
+  jobs = (job_t *) malloc ((ulong) (job_table_size) * sizeof(job_t));
+  for (i = 0; i < job_table_size; i++) {
+    if (!parser_has_value (p))
+      parser_error (p, "#exec_time has %lu values, expected %ld (#job_table_size)",
+                    i, job_table_size);
+    jobs[i].id        = i;
+    jobs[i].exec_time = parser_long_in_line (p);
+    parser_end_line (p);
   }
-  printf ("getString failed to catch %s in %s:%d\n", s, file, line);
-  exit (1);
-  return 0;
+  if (parser_has_value (p))
+    parser_error (p, "#exec_time has more than %ld values (#job_table_size)",
+                  job_table_size);
 }
 
-int getLong (FILE * f, long * l, char * file, int line) {
-  char b[64];
-  char * c;;
-  
-  if (fgets (b, 64, f) != NULL) {
-    c = strchr (b, '\n');
-    *c = '\0';
-    *l = strtol (b, NULL, 10);
-    if ((*l != 0) || (errno != EINVAL))
-      return 1;
-  }
-  return 0;
+// Called for each dependency found while scanning #preds or #edges.
+typedef void (*edge_func_t) (long pred, long job);
+
+long * edge_cursor;
+
+// First pass: count successors and predecessors of each job.
+void countEdge (long pred, long job) {
+  deps.succ_index[pred + 1]++;
+  deps.in_degree[job]++;
+  deps.n_edges++;
 }
 
-void readFile (char * filename) {
-  FILE * file;
-  ulong i;
+// Second pass: store each successor in the slot of its predecessor.
+void storeEdge (long pred, long job) {
+  deps.succs[edge_cursor[pred]++] = job;
+}
 
-  file = fopen (filename, "r");
-  if (file == NULL) {
-    printf ("cannot read file %s\n", filename);
-    exit (1);
+// Scan the dense #preds matrix.
+void scanPreds (parser_t * p, edge_func_t edge) {
+  ulong i, j;
+  long  v;
+
+  for (i = 0; i < job_table_size; i++) {
+    if (!parser_has_value (p))
+      parser_error (p, "#preds has %lu rows, expected %ld (#job_table_size)",
+                    i, job_table_size);
+    for (j = 0; j < job_table_size; j++) {
+      v = parser_long_in_line (p);
+      if ((v != 0) && (v != 1))
+        parser_error (p, "#preds values must be 0 or 1");
+      if (v && (i == j))
+        parser_error (p, "job %lu cannot precede itself", i);
+      if (v) edge (j, i);
+    }
+    parser_end_line (p);
   }
-  
-  getString (file, "#core_pool_size", __FILE__, __LINE__);
-  getLong   (file, (long *) &core_pool_size, __FILE__, __LINE__);
-  printf ("core_pool_size = %ld\n", core_pool_size);
+  if (parser_has_value (p))
+    parser_error (p, "#preds has more than %ld rows (#job_table_size)",
+                  job_table_size);
+}
 
-  getString (file, "#max_pool_size", __FILE__, __LINE__);
-  getLong   (file, (long *) &max_pool_size, __FILE__, __LINE__);
-  printf ("max_pool_size = %ld\n", max_pool_size);
+// Scan the #edges list, one "pred job" pair per line.
+void scanEdges (parser_t * p, edge_func_t edge) {
+  long pred, job;
 
-  getString (file, "#blocking_queue_size", __FILE__, __LINE__);
-  getLong   (file, (long *) &blocking_queue_size, __FILE__, __LINE__);
-  printf ("blocking_queue_size = %ld\n", blocking_queue_size);
+  while (parser_has_value (p)) {
+    pred = parser_long_in_line (p);
+    job  = parser_long_in_line (p);
+    if ((pred < 0) || (job_table_size <= pred) ||
+        (job < 0) || (job_table_size <= job))
+      parser_error (p, "#edges jobs must range from 0 to %ld", job_table_size - 1);
+    if (pred == job)
+      parser_error (p, "job %ld cannot precede itself", job);
+    parser_end_line (p);
+    edge (pred, job);
+  }
+}
 
-  getString (file, "#keep_alive_time", __FILE__, __LINE__);
-  getLong   (file, (long *) &keep_alive_time, __FILE__, __LINE__);
-  printf ("keep_alive_time = %ld\n", keep_alive_time);
+// Report an error if the dependencies form a cycle, as the jobs of
+// the cycle would never be released.
+void checkCycles (parser_t * p) {
+  long * degree = (long *) malloc (job_table_size * sizeof(long));
+  long * ready  = (long *) malloc (job_table_size * sizeof(long));
+  long   n_ready = 0, n_released = 0, i, k;
 
-  getString (file, "#period", __FILE__, __LINE__);
-  getLong   (file, (long *) &period, __FILE__, __LINE__);
+  for (i = 0; i < job_table_size; i++) {
+    degree[i] = deps.in_degree[i];
+    if (degree[i] == 0) ready[n_ready++] = i;
+  }
+  while (n_ready > 0) {
+    i = ready[--n_ready];
+    n_released++;
+    for (k = deps.succ_index[i]; k < deps.succ_index[i + 1]; k++)
+      if (--degree[deps.succs[k]] == 0) ready[n_ready++] = deps.succs[k];
+  }
+  free (degree);
+  free (ready);
+  if (n_released < job_table_size)
+    parser_error (p, "dependencies form a cycle (%ld jobs never released)",
+                  job_table_size - n_released);
+}
 
-  getString (file, "#job_table_size", __FILE__, __LINE__);
-  getLong   (file, (long *) &job_table_size, __FILE__, __LINE__);
+// Build the CSR dependencies from the #preds (dense) or #edges
+// section starting at p. The section is scanned twice: once to count
+// the edges of each job, once to store them. Nothing is kept if the
+// section holds no edge.
+void readDeps (parser_t * p, int dense) {
+  void   (*scan) (parser_t *, edge_func_t) = (dense) ? scanPreds : scanEdges;
+  parser_t section = *p;
+  long     i;
 
-  getString (file, "#exec_time", __FILE__, __LINE__);
-  jobs = (job_t *) malloc ((ulong) (job_table_size) * sizeof(job_t));
-  for (i = 0; i < job_table_size; i++) {
-    getLong (file, (long *) &jobs[i].exec_time, __FILE__, __LINE__);
-    // printf ("exec_time[%lu]=%ld\n", i, jobs[i].exec_time);
+  deps.n_edges    = 0;
+  deps.succ_index = (long *) calloc (job_table_size + 1, sizeof(long));
+  deps.in_degree  = (long *) calloc (job_table_size, sizeof(long));
+  scan (&section, countEdge);
+  if (deps.n_edges == 0) {
+    free (deps.succ_index);
+    free (deps.in_degree);
+    deps.succ_index = NULL;
+    deps.in_degree  = NULL;
+    *p = section;
+    return;
   }
 
-  
-  for (i = 0; i < job_table_size; i++) {
-    jobs[i].id = i;
+  for (i = 0; i < job_table_size; i++)
+    deps.succ_index[i + 1] += deps.succ_index[i];
+  deps.succs  = (long *) malloc (deps.n_edges * sizeof(long));
+  edge_cursor = (long *) malloc (job_table_size * sizeof(long));
+  memcpy (edge_cursor, deps.succ_index, job_table_size * sizeof(long));
+  section = *p;
+  scan (p, storeEdge);
+  free (edge_cursor);
+
+  checkCycles (&section);
+}
+
+// Read the text scenario in a single pass over the mapped file. Keys
+// may come in any order. The sections sized by #job_table_size are
+// read as soon as they are reached when #job_table_size comes first,
+// and once it is known otherwise.
+void readText (char * filename) {
+  parser_t p, exec_time, deps_section;
+  char   * key;
+  int      len;
+  long     exec_time_line = 0, deps_line = 0;
+  int      exec_time_done = 0, deps_done = 0, deps_dense = 0;
+  parser_field_t fields[] = {
+    {"#job_table_size",      &job_table_size},
+    {"#core_pool_size",      &core_pool_size},
+    {"#max_pool_size",       &max_pool_size},
+    {"#blocking_queue_size", &blocking_queue_size},
+    {"#keep_alive_time",     &keep_alive_time},
+    {"#period",              &period},
+    {NULL}
+  };
+  parser_field_t * size_field = &fields[0];
+
+  parser_open (&p, filename);
+  while (parser_next_key (&p, &key, &len)) {
+    if (parser_key_is (key, len, "#exec_time")) {
+      if (exec_time_line) {
+        p.cur = key;
+        parser_error (&p, "duplicate key #exec_time (first defined at line %ld)",
+                      exec_time_line);
+      }
+      exec_time_line = p.line;
+      exec_time = p;
+      if (size_field->line) {
+        readExecTime (&p);
+        exec_time_done = 1;
+      } else
+        parser_skip_values (&p);
+
+    } else if (parser_key_is (key, len, "#preds") ||
+               parser_key_is (key, len, "#edges")) {
+      if (deps_line) {
+        p.cur = key;
+        parser_error (&p, "duplicate dependencies (first defined at line %ld)",
+                      deps_line);
+      }
+      deps_line  = p.line;
+      deps_dense = parser_key_is (key, len, "#preds");
+      deps_section = p;
+      if (size_field->line) {
+        readDeps (&p, deps_dense);
+        deps_done = 1;
+      } else
+        parser_skip_values (&p);
+
+    } else {
+      parser_t at = p;
+      parser_read_field (&p, fields, key, len);
+      if (job_table_size < 0) {
+        at.cur = key;
+        parser_error (&at, "#job_table_size must not be negative");
+      }
+    }
   }
+  parser_check_fields (&p, fields);
+  if (!exec_time_line)
+    parser_error (&p, "missing key #exec_time");
+  if (!exec_time_done) readExecTime (&exec_time);
+  if (deps_line && !deps_done) readDeps (&deps_section, deps_dense);
+  parser_close (&p);
+}
+
+// Load a scenario image as is, or read a text scenario.
+void readFile (char * filename) {
+  if (!snapshot_load (filename))
+    readText (filename);
+
+  if (trace_activity) printf ("core_pool_size = %ld\n", core_pool_size);
+  if (trace_activity) printf ("max_pool_size = %ld\n", max_pool_size);
+  if (trace_activity) printf ("blocking_queue_size = %ld\n", blocking_queue_size);
+  if (trace_activity) printf ("keep_alive_time = %ld\n", keep_alive_time);
+  if (trace_activity && deps.n_edges)
+    printf ("dependencies = %ld\n", deps.n_edges);
 }
@@ -14,9 +14,26 @@ extern long      max_pool_size;
 extern long      blocking_queue_size;
 extern long      keep_alive_time;
 extern long      period;
+// Dependencies between jobs in compressed sparse row (CSR) form. The
+// successors of job i are succs[succ_index[i]] up to (excluded)
+// succs[succ_index[i + 1]]. in_degree[i] is the number of
+// predecessors of job i. When the scenario has no dependency,
+// n_edges is 0 and the arrays are NULL.
+typedef struct {
+  long   n_edges;
+  long * succ_index;  // job_table_size + 1 entries
+  long * succs;       // n_edges entries
+  long * in_degree;   // job_table_size entries
+} deps_t;
+
 extern job_t  *  jobs;
-#ifdef DEPS
-extern bool   ** deps;
-#endif
+extern deps_t    deps;
 
+// Read a scenario file. Dependencies are given either by #preds, a
+// dense job_table_size x job_table_size matrix where row i holds a 1
+// in column j when job j precedes job i, or by #edges, one "j i" pair
+// per line when job j precedes job i. Use #edges for large graphs: its
+// parse time scales with the number of edges. filename may also be a
+// scenario image produced by compile_scenario (see snapshot.h), which
+// is mapped in memory instead of being parsed.
 void readFile (char * filename);
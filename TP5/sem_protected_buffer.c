@@ -1,169 +1,163 @@
 #include <errno.h>
-#include <fcntl.h>
 #include <pthread.h>
 #include <semaphore.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <sys/time.h>
 #include "circular_buffer.h"
+#include "fsem.h"
 #include "protected_buffer.h"
+#include "sem_protected_buffer.h"
 #include "utils.h"
 
-#define EMPTY_SLOTS_NAME "/empty_slots"
-#define FULL_SLOTS_NAME "/full_slots"
-
-// Initialise the protected buffer structure above.
-protected_buffer_t * sem_protected_buffer_init(int length) {
-  protected_buffer_t * b;
-  b = (protected_buffer_t *)malloc(sizeof(protected_buffer_t));
-  b->buffer = circular_buffer_init(length);
-  // Initialize the synchronization attributes
-  // Use these filenames as named semaphores
-  sem_unlink (EMPTY_SLOTS_NAME);
-  sem_unlink (FULL_SLOTS_NAME);
-
-  sem_init(&(b->sem_mutex),0,1);
-  sem_init(&(b->semFull),0,0);
-  sem_init(&(b->semEmpty),0,length);
-
-  return b;
-}
-
-// Extract an element from buffer. If the attempted operation is
-// not possible immedidately, the method call blocks until it is.
-void * sem_protected_buffer_get(protected_buffer_t * b){
-  void * d;
-
-  // Enforce synchronisation semantics using semaphores.
-  sem_wait(&(b->semFull));
-  // Enter mutual exclusion.
-  sem_wait(&(b->sem_mutex));
-  d = circular_buffer_get(b->buffer);
-  print_task_activity ("get", d);
-
-  // Leave mutual exclusion.
-  sem_post(&(b->sem_mutex));
-  // Enforce synchronisation semantics using semaphores.
-  sem_post(&(b->semEmpty));
-  return d;
-}
-
-// Insert an element into buffer. If the attempted operation is
-// not possible immedidately, the method call blocks until it is.
-void sem_protected_buffer_put(protected_buffer_t * b, void * d){
-
-  // Enforce synchronisation semantics using semaphores.
-  sem_wait(&(b->semEmpty));
-  // Enter mutual exclusion.
-  sem_wait(&(b->sem_mutex));
-  circular_buffer_put(b->buffer, d);
-  print_task_activity ("put", d);
-
-  // Leave mutual exclusion.
-  sem_post(&(b->sem_mutex));
-  // Enforce synchronisation semantics using semaphores.
-  sem_post(&(b->semFull));
-}
-
-// Extract an element from buffer. If the attempted operation is not
-// possible immedidately, return NULL. Otherwise, return the element.
-void * sem_protected_buffer_remove(protected_buffer_t * b){
-  void * d = NULL;
-  int    rc = -1;
-
-  // Enforce synchronisation semantics using semaphores.
-  rc = sem_trywait(&(b->semFull));
-  if (rc != 0) {
-    print_task_activity ("remove", d);
-    return d;
-  }
-
-  // Enter mutual exclusion.
-  sem_trywait(&(b->sem_mutex));
-  d = circular_buffer_get(b->buffer);
-  print_task_activity ("remove", d);
-
-  // Leave mutual exclusion.
-  sem_post(&(b->sem_mutex));
-  // Enforce synchronisation semantics using semaphores.
-  sem_post(&(b->semEmpty));
-  return d;
-}
-
-// Insert an element into buffer. If the attempted operation is
-// not possible immedidately, return 0. Otherwise, return 1.
-int sem_protected_buffer_add(protected_buffer_t * b, void * d){
-  int rc = -1;
-
-  // Enforce synchronisation semantics using semaphores.
-  rc = sem_trywait(&(b->semEmpty));
-  if (rc != 0) {
-    print_task_activity ("add", NULL);
-    return 0;
-  }
-
-  // Enter mutual exclusion.
-  sem_trywait(&(b->sem_mutex));
-  circular_buffer_put(b->buffer, d);
-  print_task_activity ("add", d);
-
-  // Leave mutual exclusion.
-  sem_post(&(b->sem_mutex));
-  // Enforce synchronisation semantics using semaphores.
-  sem_post(&(b->semFull));
-  return 1;
+// Define the implementation PREFIX (of type PREFIX##_protected_buffer_t
+// and operations PREFIX##_protected_buffer_ops, named NAME), whose
+// slots are counted by semaphores with the primitives
+// SEM_INIT(s, value), WAIT(s), TRYWAIT(s), TIMEDWAIT(s, abstime),
+// POST(s) and SEM_DESTROY(s). TRYWAIT and TIMEDWAIT return 0 on
+// success. The buffer
+// itself is guarded by a mutex.
+//
+// get and put wait for a full (resp. empty) slot, remove and add
+// only take one if available, poll and offer wait for one no longer
+// than abstime, as described in protected_buffer.h. Each operation
+// then enters mutual exclusion to access the circular buffer, leaves
+// it, and posts the opposite semaphore.
+#define DEFINE_SEM_PROTECTED_BUFFER(PREFIX, NAME, SEM_INIT, WAIT, TRYWAIT, \
+                                    TIMEDWAIT, POST, SEM_DESTROY)          \
+  protected_buffer_t * PREFIX##_protected_buffer_init(int length) {        \
+    PREFIX##_protected_buffer_t * b;                                       \
+    b = (PREFIX##_protected_buffer_t *)                                    \
+      malloc(sizeof(PREFIX##_protected_buffer_t));                         \
+    b->base.ops = &PREFIX##_protected_buffer_ops;                          \
+    b->base.buffer = circular_buffer_init(length);                         \
+    pthread_mutex_init(&(b->mutex), NULL);                                 \
+    SEM_INIT(&(b->semFull), 0);                                            \
+    SEM_INIT(&(b->semEmpty), length);                                      \
+    return &(b->base);                                                     \
+  }                                                                        \
+                                                                           \
+  static void * PREFIX##_protected_buffer_get(protected_buffer_t * pb) {   \
+    PREFIX##_protected_buffer_t * b = (PREFIX##_protected_buffer_t *)pb;   \
+    void * d;                                                              \
+                                                                           \
+    WAIT(&(b->semFull));                                                   \
+    pthread_mutex_lock(&(b->mutex));                                       \
+    d = circular_buffer_get(b->base.buffer);                               \
+    print_task_activity ("get", d);                                        \
+    pthread_mutex_unlock(&(b->mutex));                                     \
+    POST(&(b->semEmpty));                                                  \
+    return d;                                                              \
+  }                                                                        \
+                                                                           \
+  static void PREFIX##_protected_buffer_put(protected_buffer_t * pb,       \
+                                            void * d) {                    \
+    PREFIX##_protected_buffer_t * b = (PREFIX##_protected_buffer_t *)pb;   \
+                                                                           \
+    WAIT(&(b->semEmpty));                                                  \
+    pthread_mutex_lock(&(b->mutex));                                       \
+    circular_buffer_put(b->base.buffer, d);                                \
+    print_task_activity ("put", d);                                        \
+    pthread_mutex_unlock(&(b->mutex));                                     \
+    POST(&(b->semFull));                                                   \
+  }                                                                        \
+                                                                           \
+  static void * PREFIX##_protected_buffer_remove(protected_buffer_t * pb) {\
+    PREFIX##_protected_buffer_t * b = (PREFIX##_protected_buffer_t *)pb;   \
+    void * d = NULL;                                                       \
+                                                                           \
+    if (TRYWAIT(&(b->semFull)) != 0) {                                     \
+      print_task_activity ("remove", d);                                   \
+      return d;                                                            \
+    }                                                                      \
+    pthread_mutex_lock(&(b->mutex));                                       \
+    d = circular_buffer_get(b->base.buffer);                               \
+    print_task_activity ("remove", d);                                     \
+    pthread_mutex_unlock(&(b->mutex));                                     \
+    POST(&(b->semEmpty));                                                  \
+    return d;                                                              \
+  }                                                                        \
+                                                                           \
+  static int PREFIX##_protected_buffer_add(protected_buffer_t * pb,        \
+                                           void * d) {                     \
+    PREFIX##_protected_buffer_t * b = (PREFIX##_protected_buffer_t *)pb;   \
+                                                                           \
+    if (TRYWAIT(&(b->semEmpty)) != 0) {                                    \
+      print_task_activity ("add", NULL);                                   \
+      return 0;                                                            \
+    }                                                                      \
+    pthread_mutex_lock(&(b->mutex));                                       \
+    circular_buffer_put(b->base.buffer, d);                                \
+    print_task_activity ("add", d);                                        \
+    pthread_mutex_unlock(&(b->mutex));                                     \
+    POST(&(b->semFull));                                                   \
+    return 1;                                                              \
+  }                                                                        \
+                                                                           \
+  static void * PREFIX##_protected_buffer_poll(protected_buffer_t * pb,    \
+                                               struct timespec * abstime) {\
+    PREFIX##_protected_buffer_t * b = (PREFIX##_protected_buffer_t *)pb;   \
+    void * d = NULL;                                                       \
+                                                                           \
+    if (TIMEDWAIT(&(b->semFull), abstime) != 0) {                          \
+      print_task_activity ("poll", d);                                     \
+      return d;                                                            \
+    }                                                                      \
+    pthread_mutex_lock(&(b->mutex));                                       \
+    d = circular_buffer_get(b->base.buffer);                               \
+    print_task_activity ("poll", d);                                       \
+    pthread_mutex_unlock(&(b->mutex));                                     \
+    POST(&(b->semEmpty));                                                  \
+    return d;                                                              \
+  }                                                                        \
+                                                                           \
+  static int PREFIX##_protected_buffer_offer(protected_buffer_t * pb,      \
+                                             void * d,                     \
+                                             struct timespec * abstime) {  \
+    PREFIX##_protected_buffer_t * b = (PREFIX##_protected_buffer_t *)pb;   \
+                                                                           \
+    if (TIMEDWAIT(&(b->semEmpty), abstime) != 0) {                         \
+      print_task_activity ("offer", NULL);                                 \
+      return 0;                                                            \
+    }                                                                      \
+    pthread_mutex_lock(&(b->mutex));                                       \
+    circular_buffer_put(b->base.buffer, d);                                \
+    print_task_activity ("offer", d);                                      \
+    pthread_mutex_unlock(&(b->mutex));                                     \
+    POST(&(b->semFull));                                                   \
+    return 1;                                                              \
+  }                                                                        \
+                                                                           \
+  static void PREFIX##_protected_buffer_destroy(protected_buffer_t * pb) { \
+    PREFIX##_protected_buffer_t * b = (PREFIX##_protected_buffer_t *)pb;   \
+                                                                           \
+    pthread_mutex_destroy(&(b->mutex));                                    \
+    SEM_DESTROY(&(b->semFull));                                            \
+    SEM_DESTROY(&(b->semEmpty));                                           \
+    circular_buffer_destroy(b->base.buffer);                               \
+    free(b);                                                               \
+  }                                                                        \
+                                                                           \
+  const protected_buffer_ops_t PREFIX##_protected_buffer_ops = {           \
+    NAME,                                                                  \
+    PREFIX##_protected_buffer_init,                                        \
+    PREFIX##_protected_buffer_get,                                         \
+    PREFIX##_protected_buffer_put,                                         \
+    PREFIX##_protected_buffer_remove,                                      \
+    PREFIX##_protected_buffer_add,                                         \
+    PREFIX##_protected_buffer_poll,                                        \
+    PREFIX##_protected_buffer_offer,                                       \
+    PREFIX##_protected_buffer_destroy,                                     \
+  };
+
+// POSIX semaphores shared by the threads of the process.
+static int posix_sem_init(sem_t * s, unsigned int value) {
+  return sem_init(s, 0, value);
 }
 
-// Extract an element from buffer. If the attempted operation is not
-// possible immedidately, the method call blocks until it is, but
-// waits no longer than the given timeout. Return the element if
-// successful. Otherwise, return NULL.
-void * sem_protected_buffer_poll(protected_buffer_t * b, struct timespec *abstime){
-  void * d = NULL;
-  int    rc = -1;
-
-  // Enforce synchronisation semantics using semaphores.
-  rc = sem_timedwait(&(b->semFull),abstime);
-  if (rc != 0) {
-    print_task_activity ("poll", d);
-    return d;
-  }
-
-  // Enter mutual exclusion.
-  sem_wait(&(b->sem_mutex));
-  d = circular_buffer_get(b->buffer);
-  print_task_activity ("poll", d);
-
-  // Leave mutual exclusion.
-  sem_post(&(b->sem_mutex));
-  // Enforce synchronisation semantics using semaphores.
-  sem_post(&(b->semEmpty));
-  return d;
-}
-
-// Insert an element into buffer. If the attempted operation is not
-// possible immedidately, the method call blocks until it is, but
-// waits no longer than the given timeout. Return 0 if not
-// successful. Otherwise, return 1.
-int sem_protected_buffer_offer(protected_buffer_t * b, void * d, struct timespec * abstime){
-  int rc = -1;
-
-  // Enforce synchronisation semantics using semaphores.
-  rc = sem_timedwait(&(b->semEmpty),abstime);
-  if (rc != 0) {
-    d = NULL;
-    print_task_activity ("offer", d);
-    return 0;
-  }
-
-  // Enter mutual exclusion.
-  sem_wait(&(b->sem_mutex));
-  circular_buffer_put(b->buffer, d);
-  print_task_activity ("offer", d);
-
-  // Leave mutual exclusion.
-  sem_post(&(b->sem_mutex));
-  // Enforce synchronisation semantics using semaphores.
-  sem_post(&(b->semFull));
-  return 1;
-}
+DEFINE_SEM_PROTECTED_BUFFER(fsem, "sem", fsem_init, fsem_wait,
+                            fsem_trywait, fsem_timedwait, fsem_post,
+                            fsem_destroy)
+DEFINE_SEM_PROTECTED_BUFFER(glibc_sem, "glibc-sem", posix_sem_init,
+                            sem_wait, sem_trywait, sem_timedwait, sem_post,
+                            sem_destroy)
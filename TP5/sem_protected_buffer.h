@@ -1,38 +1,38 @@
 #ifndef SEM_PROTECTED_BUFFER_H
 #define SEM_PROTECTED_BUFFER_H
 #include <pthread.h>
+#include <semaphore.h>
 #include <stdlib.h>
 #include "circular_buffer.h"
+#include "fsem.h"
 #include "protected_buffer.h"
 
-// Initialise the protected buffer structure above. 
-protected_buffer_t * sem_protected_buffer_init(int length);
+// Protected buffer synchronised by a mutex and two futex semaphores
+// counting the empty and full slots.
+typedef struct {
+  protected_buffer_t base;
+  pthread_mutex_t mutex;
+  fsem_t semEmpty;
+  fsem_t semFull;
+} fsem_protected_buffer_t;
 
-// Extract an element from buffer. If the attempted operation is
-// not possible immedidately, the method call blocks until it is.
-void * sem_protected_buffer_get(protected_buffer_t * b);
+// Protected buffer synchronised by a mutex and two POSIX semaphores
+// counting the empty and full slots.
+typedef struct {
+  protected_buffer_t base;
+  pthread_mutex_t mutex;
+  sem_t semEmpty;
+  sem_t semFull;
+} glibc_sem_protected_buffer_t;
 
-// Insert an element into buffer. If the attempted operation is
-// not possible immedidately, the method call blocks until it is.
-void sem_protected_buffer_put(protected_buffer_t * b, void * d);
+// Operations of the implementations with futex semaphores ("sem") and
+// with POSIX semaphores ("glibc-sem").
+extern const protected_buffer_ops_t fsem_protected_buffer_ops;
+extern const protected_buffer_ops_t glibc_sem_protected_buffer_ops;
 
-// Extract an element from buffer. If the attempted operation is not
-// possible immedidately, return NULL. Otherwise, return the element.
-void * sem_protected_buffer_remove(protected_buffer_t * b);
+// Initialise the fsem_protected_buffer_t structure above.
+protected_buffer_t * fsem_protected_buffer_init(int length);
 
-// Insert an element into buffer. If the attempted operation is
-// not possible immedidately, return 0. Otherwise, return 1.
-int sem_protected_buffer_add(protected_buffer_t * b, void * d);
-
-// Extract an element from buffer. If the attempted operation is not
-// possible immedidately, the method call blocks until it is, but
-// waits no longer than the given timeout. Return the element if
-// successful. Otherwise, return NULL.
-void * sem_protected_buffer_poll(protected_buffer_t * b, struct timespec * abstime);
-
-// Insert an element into buffer. If the attempted operation is not
-// possible immedidately, the method call blocks until it is, but
-// waits no longer than the given timeout. Return 0 if not
-// successful. Otherwise, return 1.
-int sem_protected_buffer_offer(protected_buffer_t * b, void * d, struct timespec * abstime);
+// Initialise the glibc_sem_protected_buffer_t structure above.
+protected_buffer_t * glibc_sem_protected_buffer_init(int length);
 #endif
@@ -0,0 +1,173 @@
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "scenario.h"
+#include "snapshot.h"
+
+// Round offset up to a multiple of 8.
+static long align8(long offset) {
+  return (offset + 7) & ~7L;
+}
+
+// Write size bytes of data at offset of file f.
+static void write_at(FILE * f, char * filename, long offset,
+                     void * data, long size) {
+  if ((fseek(f, offset, SEEK_SET) != 0) ||
+      (fwrite(data, 1, size, f) != (size_t) size)) {
+    printf("cannot write file %s\n", filename);
+    exit(1);
+  }
+}
+
+// Set the offsets and the size of the image described by h from its
+// job_table_size and n_edges.
+static void snapshot_layout(snapshot_header_t * h) {
+  h->jobs = align8(sizeof(snapshot_header_t));
+  h->size = h->jobs + h->job_table_size * sizeof(job_t);
+  h->succ_index = h->succs = h->in_degree = 0;
+  if (h->n_edges != 0) {
+    h->succ_index = align8(h->size);
+    h->succs      = h->succ_index + (h->job_table_size + 1) * sizeof(long);
+    h->in_degree  = h->succs + h->n_edges * sizeof(long);
+    h->size       = h->in_degree + h->job_table_size * sizeof(long);
+  }
+}
+
+void snapshot_write(char * filename) {
+  snapshot_header_t h;
+  FILE *            f;
+
+  memset(&h, 0, sizeof(h));
+  memcpy(h.magic, SNAPSHOT_MAGIC, sizeof(h.magic));
+  h.version             = SNAPSHOT_VERSION;
+  h.header_size         = sizeof(snapshot_header_t);
+  h.long_size           = sizeof(long);
+  h.job_size            = sizeof(job_t);
+  h.job_table_size      = job_table_size;
+  h.core_pool_size      = core_pool_size;
+  h.max_pool_size       = max_pool_size;
+  h.blocking_queue_size = blocking_queue_size;
+  h.keep_alive_time     = keep_alive_time;
+  h.period              = period;
+  h.n_edges             = deps.n_edges;
+
+  snapshot_layout(&h);
+  f = fopen(filename, "wb");
+  if (f == NULL) {
+    printf("cannot create file %s\n", filename);
+    exit(1);
+  }
+  write_at(f, filename, 0, &h, sizeof(h));
+  write_at(f, filename, h.jobs, jobs, job_table_size * sizeof(job_t));
+  if (deps.n_edges != 0) {
+    write_at(f, filename, h.succ_index, deps.succ_index,
+             (job_table_size + 1) * sizeof(long));
+    write_at(f, filename, h.succs, deps.succs, deps.n_edges * sizeof(long));
+    write_at(f, filename, h.in_degree, deps.in_degree,
+             job_table_size * sizeof(long));
+  }
+  if (fclose(f) != 0) {
+    printf("cannot write file %s\n", filename);
+    exit(1);
+  }
+}
+
+// Report a malformed image and exit.
+static void snapshot_error(char * filename, char * msg) {
+  printf("%s: %s\n", filename, msg);
+  exit(1);
+}
+
+// Check that the arrays of the image loaded into the scenario globals
+// are consistent, so that they can be indexed without bound checks:
+// jobs are numbered in order, and the dependencies form a valid CSR
+// whose in-degrees match the edges. Takes O(job_table_size + n_edges).
+static void snapshot_check(char * filename) {
+  long * count;
+  long   i, k;
+
+  for (i = 0; i < job_table_size; i++)
+    if (jobs[i].id != i)
+      snapshot_error(filename, "corrupted image (job ids)");
+  if (deps.n_edges == 0) return;
+
+  if (deps.succ_index[0] != 0)
+    snapshot_error(filename, "corrupted image (successor index)");
+  for (i = 0; i < job_table_size; i++)
+    if (deps.succ_index[i + 1] < deps.succ_index[i])
+      snapshot_error(filename, "corrupted image (successor index)");
+  if (deps.succ_index[job_table_size] != deps.n_edges)
+    snapshot_error(filename, "corrupted image (successor index)");
+
+  count = (long *) calloc(job_table_size, sizeof(long));
+  for (k = 0; k < deps.n_edges; k++) {
+    if ((deps.succs[k] < 0) || (job_table_size <= deps.succs[k]))
+      snapshot_error(filename, "corrupted image (successors)");
+    count[deps.succs[k]]++;
+  }
+  for (i = 0; i < job_table_size; i++)
+    if (deps.in_degree[i] != count[i])
+      snapshot_error(filename, "corrupted image (in-degrees)");
+  free(count);
+}
+
+int snapshot_load(char * filename) {
+  snapshot_header_t * h, layout;
+  struct stat         st;
+  char                magic[8];
+  char              * data;
+  int                 fd;
+
+  fd = open(filename, O_RDONLY);
+  if ((fd < 0) || (fstat(fd, &st) < 0)) {
+    printf("cannot read file %s\n", filename);
+    exit(1);
+  }
+  if ((read(fd, magic, sizeof(magic)) != sizeof(magic)) ||
+      (memcmp(magic, SNAPSHOT_MAGIC, sizeof(magic)) != 0)) {
+    close(fd);
+    return 0;
+  }
+  if (st.st_size < (long) sizeof(snapshot_header_t))
+    snapshot_error(filename, "truncated or corrupted image");
+
+  data = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    printf("cannot map file %s\n", filename);
+    exit(1);
+  }
+
+  h = (snapshot_header_t *) data;
+  if (h->version != SNAPSHOT_VERSION)
+    snapshot_error(filename, "unsupported image version, recompile the scenario");
+  if ((h->header_size != sizeof(snapshot_header_t)) ||
+      (h->long_size != sizeof(long)) || (h->job_size != sizeof(job_t)))
+    snapshot_error(filename, "image compiled for another architecture");
+  layout = *h;
+  snapshot_layout(&layout);
+  if ((h->job_table_size < 0) || (h->n_edges < 0) ||
+      (memcmp(&layout, h, sizeof(layout)) != 0) || (h->size != st.st_size))
+    snapshot_error(filename, "truncated or corrupted image");
+
+  job_table_size      = h->job_table_size;
+  core_pool_size      = h->core_pool_size;
+  max_pool_size       = h->max_pool_size;
+  blocking_queue_size = h->blocking_queue_size;
+  keep_alive_time     = h->keep_alive_time;
+  period              = h->period;
+  jobs                = (job_t *) (data + h->jobs);
+  deps.n_edges        = h->n_edges;
+  if (deps.n_edges != 0) {
+    deps.succ_index = (long *) (data + h->succ_index);
+    deps.succs      = (long *) (data + h->succs);
+    deps.in_degree  = (long *) (data + h->in_degree);
+  }
+  snapshot_check(filename);
+  return 1;
+}
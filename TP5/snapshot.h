@@ -0,0 +1,51 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+// Binary image of a compiled scenario. The image is mapped as is by
+// main_executor: jobs and dependencies are used in place, without any
+// parsing or copy. The file starts with the header below, followed by
+// the arrays it refers to (offsets in bytes from the start of the
+// file, aligned on 8 bytes):
+//
+//   jobs        job_table_size job_t
+//   succ_index  job_table_size + 1 longs (when n_edges != 0)
+//   succs       n_edges longs            (when n_edges != 0)
+//   in_degree   job_table_size longs     (when n_edges != 0)
+//
+// The image is only valid on a host with the same long and job_t
+// layout, which the header records.
+#define SNAPSHOT_MAGIC   "TP5SCEN"
+#define SNAPSHOT_VERSION 1
+
+typedef struct {
+  char magic[8];
+  int  version;
+  int  header_size;
+  int  long_size;
+  int  job_size;
+  long job_table_size;
+  long core_pool_size;
+  long max_pool_size;
+  long blocking_queue_size;
+  long keep_alive_time;
+  long period;
+  long n_edges;
+  long jobs;        // Offset of jobs
+  long succ_index;  // Offset of deps.succ_index
+  long succs;       // Offset of deps.succs
+  long in_degree;   // Offset of deps.in_degree
+  long size;        // Size of the image
+} snapshot_header_t;
+
+// Write the scenario currently loaded (see scenario.h) into file
+// filename.
+void snapshot_write(char * filename);
+
+// Return 0 if file filename is not a scenario image. Otherwise map it,
+// check its header and the consistency of its arrays (exiting with an
+// error if the image is truncated or corrupted), and make the scenario
+// globals point into the mapping. The mapping is
+// private and writable: pages written by the executor (in_degree) are
+// copied on write, the file itself is never modified.
+int snapshot_load(char * filename);
+#endif
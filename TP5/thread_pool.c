@@ -13,6 +13,8 @@ thread_pool_t * thread_pool_init(int core_pool_size, int max_pool_size) {
   thread_pool->core_pool_size = core_pool_size;
   thread_pool->max_pool_size  = max_pool_size;
   thread_pool->size           = 0;
+  thread_pool->shutdown       = 0;
+  thread_pool->n_created      = 0;
   pthread_mutex_init(&(thread_pool->pool_mutex),NULL);
   pthread_cond_init(&(thread_pool->pool_cond),NULL);
   return thread_pool;
@@ -39,41 +41,45 @@ int pool_thread_create (thread_pool_t * thread_pool,
     pthread_create(&thread, NULL, main, future);
     done = 1;
     thread_pool->size++;
+    thread_pool->n_created++;
   }
 
   // Do not protect the structure against concurrent accesses anymore
   pthread_mutex_unlock(&(thread_pool->pool_mutex));
-  if (done)
+  if (done && trace_activity)
     printf("%06ld [pool_thread] created\n", relative_clock());
   return done;
 }
 
 void thread_pool_shutdown(thread_pool_t * thread_pool) {
+  pthread_mutex_lock(&(thread_pool->pool_mutex));
   thread_pool->shutdown = 1;
+  pthread_mutex_unlock(&(thread_pool->pool_mutex));
 }
 
 // When a thread wants to be deallocated, check whether the number of
-// threads already allocated is large enough. If so, decrease threads
-// number and broadcast update. Protect against concurrent accesses.
+// threads already allocated is large enough or whether the pool is
+// shut down. If so, decrease threads number and broadcast update.
+// Protect against concurrent accesses.
 int pool_thread_remove (thread_pool_t * thread_pool) {
-  int done = 1;
+  int done = 0;
 
   // Protect against concurrent accesses and check whether the thread
   // can be deallocated.
   pthread_mutex_lock(&(thread_pool->pool_mutex));
 
-  if (thread_pool->size > thread_pool->core_pool_size)
-    thread_pool->size--;
-
-  if (thread_pool->shutdown)
+  if ((thread_pool->size > thread_pool->core_pool_size) ||
+      thread_pool->shutdown) {
     thread_pool->size--;
+    done = 1;
+  }
 
   if (thread_pool->size==0)
     pthread_cond_broadcast(&(thread_pool->pool_cond));
 
   pthread_mutex_unlock(&(thread_pool->pool_mutex));
 
-  if (done)
+  if (done && trace_activity)
     printf("%06ld [pool_thread] terminated\n", relative_clock());
   return done;
 }  
@@ -94,3 +100,12 @@ void wait_thread_pool_empty (thread_pool_t * thread_pool) {
 int get_shutdown(thread_pool_t * thread_pool) {
   return thread_pool->shutdown;
 }
+
+int get_pool_size(thread_pool_t * thread_pool) {
+  int size;
+
+  pthread_mutex_lock(&(thread_pool->pool_mutex));
+  size = thread_pool->size;
+  pthread_mutex_unlock(&(thread_pool->pool_mutex));
+  return size;
+}
@@ -12,6 +12,7 @@ typedef struct {
   int             max_pool_size;
   int             size;
   int             shutdown;
+  int             n_created;  // Number of threads created so far
   pthread_mutex_t pool_mutex;
   pthread_cond_t  pool_cond;
 } thread_pool_t;
@@ -35,6 +36,9 @@ void thread_pool_shutdown(thread_pool_t * thread_pool);
 // Getter
 int get_shutdown(thread_pool_t * thread_pool);
 
+// Getter
+int get_pool_size(thread_pool_t * thread_pool);
+
 // Decrease thread number and broadcast update. Return whether thread
 // was actually removed.
 int pool_thread_remove(thread_pool_t * thread_pool);
@@ -7,6 +7,8 @@
 
 #include "utils.h"
 
+long trace_activity = 1; // Log pool activity (0 when reporting CSV)
+
 // Start time as a timespec
 struct timespec start_time;
 
@@ -75,39 +77,6 @@ void set_start_time() {
   TIMEVAL_TO_TIMESPEC(&tv_start_time, &start_time);
 }
 
-// Read string in file f and store it in s. If there is an error,
-// provide filename and line number (file:line).
-int get_string (FILE * f, char * s, char * file, int line) {
-  char b[64];
-  char * c;;
-  
-  while (fgets (b, 64, f) != NULL) {
-    c = strchr (b, '\n');
-    *c = '\0';
-    if (strcmp (s, b) == 0)
-      return 1;
-  }
-  printf ("getString failed to catch %s in %s:%d\n", s, file, line);
-  exit (1);
-  return 0;
-}
-
-// Read long in file f and store it in l. If there is an error,
-// provide filename and line number (file:line).
-int get_long (FILE * f, long * l, char * file, int line) {
-  char b[64];
-  char * c;;
-  
-  if (fgets (b, 64, f) != NULL) {
-    c = strchr (b, '\n');
-    *c = '\0';
-    *l = strtol (b, NULL, 10);
-    if ((*l != 0) || (errno != EINVAL))
-      return 1;
-  }
-  return 0;
-}
-
 void print_task_activity(char * action, int * data) {};
 
 #ifdef DARWIN
@@ -0,0 +1,127 @@
+#!/bin/sh
+# Run a scenario matrix against the protected buffer benchmark (TP3)
+# or the executor (TP5) and collect the results as a single CSV file.
+#
+# Usage : ./sweep.sh buffer|executor [-o results.csv] [-r repeats]
+#
+# The matrix is the cartesian product of the lists below. Override
+# any of them from the environment, e.g.
+#   BUFFER_SIZES="1 64" N_PRODUCERS="1 4" ./sweep.sh buffer -o b.csv
+#
+# Each row starts with the repeat index and the scenario file name,
+# followed by the columns reported by the driver in CSV mode (-c).
+# Scenario files are kept in the directory given by SCENARIO_DIR so
+# that any row can be replayed.
+
+# Protected buffer matrix (IMPLS are sem_impl values: 0 cond, 1 futex
+# semaphores, 2 glibc sem_t)
+IMPLS=${IMPLS:-"0 1 2"}
+SEMANTICS=${SEMANTICS:-"0"}
+BUFFER_SIZES=${BUFFER_SIZES:-"1 16 256"}
+N_VALUES=${N_VALUES:-"100000"}
+N_PRODUCERS=${N_PRODUCERS:-"1 2 4"}
+N_CONSUMERS=${N_CONSUMERS:-"1 2 4"}
+
+# Executor matrix
+CORE_POOL_SIZES=${CORE_POOL_SIZES:-"1 2 4"}
+MAX_POOL_SIZES=${MAX_POOL_SIZES:-"4 8"}
+BLOCKING_QUEUE_SIZES=${BLOCKING_QUEUE_SIZES:-"4 64"}
+KEEP_ALIVE_TIMES=${KEEP_ALIVE_TIMES:-"-1 100"}
+JOB_TABLE_SIZES=${JOB_TABLE_SIZES:-"100"}
+EXEC_TIME=${EXEC_TIME:-"1"}
+
+ROOT=$(cd "$(dirname "$0")" && pwd)
+SCENARIO_DIR=${SCENARIO_DIR:-$(mktemp -d "${TMPDIR:-/tmp}/sweep.XXXXXX")}
+OUTPUT=/dev/stdout
+REPEATS=1
+
+usage() {
+  echo "Usage : $0 buffer|executor [-o results.csv] [-r repeats]" >&2
+  exit 1
+}
+
+[ $# -ge 1 ] || usage
+KIND=$1
+shift
+while [ $# -gt 0 ]; do
+  case $1 in
+    -o) OUTPUT=$2; shift 2 ;;
+    -r) REPEATS=$2; shift 2 ;;
+    *) usage ;;
+  esac
+done
+
+# Run driver on scenario file $2 for every repeat and append its CSV
+# rows to the output. Only the first header line is kept.
+run() {
+  r=1
+  while [ "$r" -le "$REPEATS" ]; do
+    $1 "$2" -c | while IFS= read -r line; do
+      case $line in
+        *_ns*) [ -f "$SCENARIO_DIR/.header" ] && continue
+               echo "repeat,scenario,$line" >>"$OUTPUT"
+               touch "$SCENARIO_DIR/.header" ;;
+        *) echo "$r,$(basename "$2"),$line" >>"$OUTPUT" ;;
+      esac
+    done
+    r=$((r + 1))
+  done
+}
+
+sweep_buffer() {
+  driver=$ROOT/TP3/main_protected_buffer
+  [ -x "$driver" ] || (cd "$ROOT/TP3" && make >&2) || exit 1
+  n=0
+  for impl in $IMPLS; do
+  for semantics in $SEMANTICS; do
+  for buffer_size in $BUFFER_SIZES; do
+  for n_values in $N_VALUES; do
+  for n_producers in $N_PRODUCERS; do
+  for n_consumers in $N_CONSUMERS; do
+    n=$((n + 1))
+    f=$SCENARIO_DIR/buffer-$n.txt
+    printf '#sem_impl\n%s\n\n#semantics\n%s\n\n#buffer_size\n%s\n\n' \
+      "$impl" "$semantics" "$buffer_size" >"$f"
+    printf '#n_values\n%s\n\n#n_consumers\n%s\n\n#n_producers\n%s\n\n' \
+      "$n_values" "$n_consumers" "$n_producers" >>"$f"
+    printf '#consumer_period\n0\n\n#producer_period\n0\n' >>"$f"
+    run "$driver" "$f"
+  done; done; done; done; done; done
+}
+
+sweep_executor() {
+  driver=$ROOT/TP5/main_executor
+  [ -x "$driver" ] || (cd "$ROOT/TP5" && make >&2) || exit 1
+  n=0
+  for core_pool_size in $CORE_POOL_SIZES; do
+  for max_pool_size in $MAX_POOL_SIZES; do
+  for blocking_queue_size in $BLOCKING_QUEUE_SIZES; do
+  for keep_alive_time in $KEEP_ALIVE_TIMES; do
+  for job_table_size in $JOB_TABLE_SIZES; do
+    [ "$core_pool_size" -le "$max_pool_size" ] || continue
+    n=$((n + 1))
+    f=$SCENARIO_DIR/executor-$n.txt
+    printf '#core_pool_size\n%s\n\n#max_pool_size\n%s\n\n' \
+      "$core_pool_size" "$max_pool_size" >"$f"
+    printf '#blocking_queue_size\n%s\n\n#keep_alive_time\n%s\n\n' \
+      "$blocking_queue_size" "$keep_alive_time" >>"$f"
+    printf '#period\n0\n\n#job_table_size\n%s\n\n#exec_time\n' \
+      "$job_table_size" >>"$f"
+    i=0
+    while [ "$i" -lt "$job_table_size" ]; do
+      echo "$EXEC_TIME" >>"$f"
+      i=$((i + 1))
+    done
+    run "$driver" "$f"
+  done; done; done; done; done
+}
+
+[ "$OUTPUT" = /dev/stdout ] || : >"$OUTPUT"
+rm -f "$SCENARIO_DIR/.header"
+case $KIND in
+  buffer) sweep_buffer ;;
+  executor) sweep_executor ;;
+  *) usage ;;
+esac
+rm -f "$SCENARIO_DIR/.header"
+echo "scenarios kept in $SCENARIO_DIR" >&2